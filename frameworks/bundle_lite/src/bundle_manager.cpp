@@ -259,7 +259,8 @@ static int Notify(IOwner owner, int code, IpcIo *reply)
     ReadUint8(reply, &resultCode);
     switch (resultCode) {
         case INSTALL:
-        case UNINSTALL: {
+        case UNINSTALL:
+        case INSTALL_BATCH: {
             uint8_t *ret = reinterpret_cast<uint8_t *>(owner);
             ReadUint8(reply, ret);
             HILOG_INFO(HILOG_MODULE_APP, "BundleManager install or uninstall invoke return: %{public}d", *ret);
@@ -294,7 +295,8 @@ static int Notify(IOwner owner, int code, IpcIo *reply)
 #ifdef OHOS_DEBUG
         case SET_EXTERNAL_INSTALL_MODE:
         case SET_SIGN_DEBUG_MODE:
-        case SET_SIGN_MODE: {
+        case SET_SIGN_MODE:
+        case SET_ARCHIVE_INSTALL_MODE: {
             uint8_t *ret = reinterpret_cast<uint8_t *>(owner);
             ReadUint8(reply, ret);
             break;
@@ -378,6 +380,61 @@ bool Install(const char *hapPath, const InstallParam *installParam, InstallerCal
     return result == OHOS_SUCCESS;
 }
 
+bool InstallBatch(const char *hapPaths[], int32_t num, const InstallParam *installParam,
+    InstallerCallback installerCallback)
+{
+    if ((hapPaths == nullptr) || (installerCallback == nullptr) || (installParam == nullptr) || (num <= 0) ||
+        (num > MAX_INSTALL_BATCH_NUM)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager install batch failed due to nullptr or invalid parameters");
+        return false;
+    }
+    for (int32_t i = 0; i < num; i++) {
+        if (hapPaths[i] == nullptr) {
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleManager install batch failed due to nullptr path");
+            return false;
+        }
+    }
+    if (CheckSelfPermission(static_cast<const char *>(PERMISSION_INSTALL_BUNDLE)) != GRANTED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager install batch failed due to permission denied");
+        return false;
+    }
+    auto bmsInnerClient = GetBmsInnerClient();
+    if (bmsInnerClient == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager install batch failed due to nullptr bms client");
+        return false;
+    }
+
+    IpcIo ipcIo;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&ipcIo, data, MAX_IO_SIZE, OBJECT_NUMBER_IN_INSTALLATION);
+    WriteInt32(&ipcIo, num);
+    for (int32_t i = 0; i < num; i++) {
+        if (!WriteString(&ipcIo, hapPaths[i])) {
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch paths exceed the ipc size");
+            return false;
+        }
+    }
+    const SvcIdentity *svc = OHOS::BundleSelfCallback::GetInstance().RegisterBundleSelfCallback(installerCallback);
+    if (svc == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch svc is nullptr");
+        return false;
+    }
+    bool writeRemote = WriteRemoteObject(&ipcIo, svc);
+    if (!writeRemote) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch ipc failed");
+        return false;
+    }
+    WriteInt32(&ipcIo, installParam->installLocation);
+    HILOG_DEBUG(HILOG_MODULE_APP, "BMS client invoke install batch");
+    uint8_t result = 0;
+    int32_t ret = bmsInnerClient->Invoke(bmsInnerClient, INSTALL_BATCH, &ipcIo, &result, Notify);
+    if (ret != OHOS_SUCCESS) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch invoke failed: %{public}d", ret);
+        return false;
+    }
+    return result == OHOS_SUCCESS;
+}
+
 bool Uninstall(const char *bundleName, const InstallParam *installParam, InstallerCallback installerCallback)
 {
     // installParam is nullptr at present.
@@ -16,6 +16,8 @@
 #ifndef OHOS_BUNDLE_DAEMON_INTERFACE_H
 #define OHOS_BUNDLE_DAEMON_INTERFACE_H
 
+#include <stdint.h>
+
 #include "iproxy_server.h"
 
 #ifdef __cplusplus
@@ -35,11 +37,22 @@ enum BmsCmd {
     MOVE_FILE,             // move file to target dictionary
     REMOVE_FILE,            // delete json path
     REMOVE_INSTALL_DIRECTORY, // clear app data path and code path
+    EXTRACT_HAP_ARCHIVE,      // keep hap in code path and extract only profile, resource index and shared libs
+    EXTRACT_HAP_UPDATE,       // extract hap and link the files unchanged from the installed code path
+    APPLY_HAP_PATCH,          // rebuild a hap from a patch file and the installed code path
+    APPEND_CONTENT_TO_FILE,   // append content to json path, flush it if asked
     BDS_CMD_END,
     REGISTER_CALLBACK,    // register bundle_daemon callback
     BDS_CALLBACK          // callback message
 };
 
+// sent after the result of EXTRACT_HAP, EXTRACT_HAP_ARCHIVE and EXTRACT_HAP_UPDATE
+typedef struct {
+    uint32_t bytesRead;    // compressed bytes of the entries which were extracted
+    uint32_t bytesWritten; // bytes of the files written to the code path, linked files are not counted
+    uint32_t fileCount;    // files written to the code path
+} BdsExtractStats;
+
 #ifdef __cplusplus
 #if __cplusplus
 }
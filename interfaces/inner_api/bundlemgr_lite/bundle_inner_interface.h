@@ -30,6 +30,7 @@ extern "C" {
 const char BMS_SERVICE[] = "bundlems";
 const char BMS_FEATURE[] = "BmsFeature";
 const char BMS_INNER_FEATURE[] = "BmsInnerFeature";
+const int32_t MAX_INSTALL_BATCH_NUM = 16;
 
 enum BmsCmd {
     QUERY_ABILITY_INFO = 0,
@@ -45,10 +46,13 @@ enum BmsCmd {
     BMS_INNER_BEGIN,
     INSTALL = BMS_INNER_BEGIN, // bms install application
     UNINSTALL,
+    INSTALL_BATCH, // bms install several applications with one commit
+    DUMP_INSTALL_STATE, // bms dump the state of the installation queue
 #ifdef OHOS_DEBUG
     SET_EXTERNAL_INSTALL_MODE,
     SET_SIGN_DEBUG_MODE,
     SET_SIGN_MODE,
+    SET_ARCHIVE_INSTALL_MODE,
 #endif
     BMS_CMD_END
 };
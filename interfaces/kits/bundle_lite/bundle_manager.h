@@ -111,6 +111,27 @@ int32_t UnregisterCallback(void);
  */
 bool Install(const char *hapPath, const InstallParam *installParam, InstallerCallback installerCallback);
 
+/**
+ * @brief Installs or updates several applications together.
+ *
+ * The HAPs are verified and staged one after another, and the installation records of all staged applications are
+ * committed together at the end, so a batch costs one commit instead of one per application. A HAP that fails
+ * does not stop the others.
+ *
+ * @param hapPaths Indicates the array of paths of the HAPs to install or update. Each application may appear only
+ *                 once, and at most 16 paths can be passed.
+ * @param num Indicates the number of paths in <b>hapPaths</b>.
+ * @param installParam Indicates the pointer to the parameters used for the installation or update of every HAP.
+ * @param installerCallback Indicates the callback to be invoked once for each HAP, in the order of <b>hapPaths</b>,
+ *                          for notifying its installation or update result.
+ * @return Returns <b>true</b> if this function is successfully called; returns <b>false</b> otherwise.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+bool InstallBatch(const char *hapPaths[], int32_t num, const InstallParam *installParam,
+    InstallerCallback installerCallback);
+
 /**
  * @brief Uninstalls an application.
  *
@@ -53,6 +53,10 @@ private:
     static int32_t MoveFileInvoke(IpcIo *req);
     static int32_t RemoveFileInvoke(IpcIo *req);
     static int32_t RemoveInstallDirectoryInvoke(IpcIo *req);
+    static int32_t ExtractHapArchiveInvoke(IpcIo *req);
+    static int32_t ExtractHapUpdateInvoke(IpcIo *req);
+    static int32_t ApplyHapPatchInvoke(IpcIo *req);
+    static int32_t AppendContentToFileInvoke(IpcIo *req);
     static constexpr InvokeFunc invokeFuncs[BDS_CMD_END] {
         BundleDaemon::ExtractHapInvoke,
         BundleDaemon::RenameFileInvoke,
@@ -62,6 +66,10 @@ private:
         BundleDaemon::MoveFileInvoke,
         BundleDaemon::RemoveFileInvoke,
         BundleDaemon::RemoveInstallDirectoryInvoke,
+        BundleDaemon::ExtractHapArchiveInvoke,
+        BundleDaemon::ExtractHapUpdateInvoke,
+        BundleDaemon::ApplyHapPatchInvoke,
+        BundleDaemon::AppendContentToFileInvoke,
     };
 };
 
@@ -17,26 +17,54 @@
 #define OHOS_BUNDLE_DAEMON_HANDLER_H
 
 #include <cstdint>
+#include <string>
 
+#include "bundle_daemon_interface.h"
+#include "bundle_extract_writer.h"
 #include "nocopyable.h"
 #include "ohos_types.h"
+#include "zip_file.h"
 
 namespace OHOS {
+class BundleHapManifest;
+class ExtractorUtil;
+
 class BundleDaemonHandler : public NoCopyable {
 public:
     int32_t ExtractHap(const char *hapPath, const char *codePath);
+    // extracts only what is needed outside the runtime and keeps the hap itself in codePath for the rest
+    int32_t ExtractHapArchive(const char *hapPath, const char *codePath);
+    // like ExtractHap or ExtractHapArchive, but links the files which are unchanged from installedPath
+    int32_t ExtractHapUpdate(const char *hapPath, const char *codePath, const char *installedPath,
+        bool isArchiveMode);
+    // writes the hap described by patchPath against the installed module in baseCodePath to hapPath
+    int32_t ApplyHapPatch(const char *patchPath, const char *baseCodePath, const char *hapPath);
     int32_t RenameFile(const char *oldFile, const char *newFile);
     int32_t CreatePermissionDir();
     int32_t CreateDataDirectory(const char *dataPath, int32_t uid, int32_t gid, bool isChown);
     int32_t StoreContentToFile(const char *filePath, const void *buffer, uint32_t size);
+    // with isSync it returns once the whole file is durable, a failed append leaves the file as it was
+    int32_t AppendContentToFile(const char *filePath, const void *buffer, uint32_t size, bool isSync);
     int32_t MoveFile(const char *oldFile, const char *newFile);
     int32_t RemoveFile(const char *file);
     int32_t RemoveInstallDirectory(const char *codePath, const char *dataPath, bool keepData);
+    // what the last ExtractHap, ExtractHapArchive or ExtractHapUpdate read and wrote
+    const BdsExtractStats &GetExtractStats() const;
 private:
+    int32_t ExtractHapFiles(const char *hapPath, const char *codePath, bool isArchiveMode,
+        const char *installedPath);
+    static bool LinkUnchangedFile(const std::string &fileName, const std::string &installedDir,
+        const BundleHapManifest &installedManifest, BundleExtractWriter &extractWriter);
+    static bool IsArchiveResidentFile(const std::string &fileName);
+    // false if the files to extract do not fit into codeDir, the linked unchanged files are not counted
+    static bool HasSpaceToExtract(const ExtractorUtil &extractorUtil, const std::string &codeDir,
+        bool isArchiveMode, const BundleHapManifest *installedManifest);
     bool IsValideCodePath(const char *codePath);
     bool IsValideDataPath(const char *codePath);
     bool IsValideJsonPath(const char *jsonPath);
     bool IsValideSystemPath(const char *jsonPath);
+
+    BdsExtractStats extractStats_ {};
 };
 } // OHOS
 #endif // OHOS_BUNDLE_DAEMON_HANDLER_H
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_DEDUP_STORE_H
+#define OHOS_BUNDLE_DEDUP_STORE_H
+
+#include <string>
+#include <vector>
+
+#include "bundle_extract_writer.h"
+#include "extractor_util.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+// content addressed store shared by all installed bundles. A store object is named after the crc32 and size of
+// its content and every installed copy is a hard link to it, so its link count is the reference count. Objects
+// are only linked after a full content comparison, a crc32 and size match alone is not trusted.
+class BundleDedupStore : public NoCopyable {
+public:
+    BundleDedupStore(const ExtractorUtil &extractorUtil, const std::string &codeDir);
+    ~BundleDedupStore() override = default;
+
+    // false if the store is disabled or can not be linked from codeDir, e.g. it is on another filesystem.
+    bool Init();
+    // creates fileName in writer as a link to a store object with the same content, false if there is none.
+    bool LinkFromStore(const std::string &fileName, BundleExtractWriter &writer) const;
+    // adds the file just extracted from fileName to filePath to the store.
+    void AddToStore(const std::string &fileName, const std::string &filePath) const;
+    // the store objects the files under path are linked to, taken before path is removed or replaced.
+    static std::vector<std::string> GetLinkedObjects(const char *path);
+    // removes those of objects which are not linked by any installed bundle anymore.
+    static void Collect(const std::vector<std::string> &objects);
+    // walks the whole store for the objects a power loss kept from being collected, once at start.
+    static void CollectAll();
+private:
+    static void FindLinkedObjects(const std::string &path, std::vector<std::string> &objects);
+    bool GetObjectPrefix(const std::string &fileName, ZipEntry &zipEntry, std::string &prefix) const;
+    bool IsSameContent(const std::string &fileName, const ZipEntry &zipEntry, const std::string &objectPath) const;
+
+    const ExtractorUtil &extractorUtil_;
+    std::string codeDir_;
+};
+} // OHOS
+#endif // OHOS_BUNDLE_DEDUP_STORE_H
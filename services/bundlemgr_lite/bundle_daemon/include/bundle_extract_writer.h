@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_EXTRACT_WRITER_H
+#define OHOS_BUNDLE_EXTRACT_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "nocopyable.h"
+
+namespace OHOS {
+// creates the files of an extracted hap relative to open directory fds, so each file costs about one syscall
+// to resolve instead of an access/mkdir walk over its whole path.
+class BundleExtractWriter : public NoCopyable {
+public:
+    explicit BundleExtractWriter(const std::string &rootDir);
+    ~BundleExtractWriter() override;
+
+    bool Init();
+    // relativePath is relative to rootDir, returns a fd opened for read and write or -1.
+    int32_t CreateFile(const std::string &relativePath);
+    // creates relativePath as a hard link to sourceFile.
+    bool LinkFile(const std::string &relativePath, const std::string &sourceFile);
+private:
+    int32_t OpenParentDir(const std::string &relativePath, std::string &name);
+    int32_t OpenDir(const std::string &relativeDir);
+    void CloseDirs();
+
+    std::string rootDir_;
+    int32_t rootFd_ = -1;
+    // key is the directory relative to rootDir_ with a trailing separator.
+    std::unordered_map<std::string, int32_t> dirFds_;
+};
+} // OHOS
+#endif // OHOS_BUNDLE_EXTRACT_WRITER_H
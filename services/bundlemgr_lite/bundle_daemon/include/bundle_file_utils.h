@@ -35,6 +35,14 @@ public:
     static bool RenameFile(const char *oldDir, const char *newDir);
     static bool ChownFile(const char *file, int32_t uid, int32_t gid);
     static bool WriteFile(const char *file, const void *buffer, uint32_t size);
+    static bool AppendFile(const char *file, const void *buffer, uint32_t size, bool isSync);
+    static bool SyncDir(const char *dir);
+    static bool LinkOrCopyFile(const char *oldFile, const char *newFile);
+    // reserves size bytes for fd ahead of the writes without changing its size. False only if the filesystem is
+    // out of space, a filesystem which cannot preallocate just gets the writes.
+    static bool PreallocateFile(int32_t fd, uint64_t size);
+    // the space below dir which is left to unprivileged writers, blockSize is its allocation unit.
+    static bool GetFreeSpace(const char *dir, uint64_t &freeSize, uint64_t &blockSize);
     static bool IsValidPath(const std::string &rootDir, const std::string &path);
     static std::string GetPathDir(const std::string &path);
 };
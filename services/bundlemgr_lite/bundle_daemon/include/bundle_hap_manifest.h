@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_HAP_MANIFEST_H
+#define OHOS_BUNDLE_HAP_MANIFEST_H
+
+#include <cstdint>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+
+#include "nocopyable.h"
+#include "zip_file.h"
+
+namespace OHOS {
+// list of the files extracted into a code path together with the crc32 and sizes of the hap entries they came
+// from, and the inode and mtime of the files. It is written last into the staging directory, so an installed code
+// path either has a complete manifest or none, and an update uses it to find the files it can link instead of
+// extracting again.
+class BundleHapManifest : public NoCopyable {
+public:
+    BundleHapManifest() = default;
+    ~BundleHapManifest() override = default;
+
+    // false if codeDir has no manifest or it can not be read.
+    bool Load(const std::string &codeDir);
+    // true if fileName was extracted from an entry with the same crc32, sizes and compression method.
+    bool IsUnchanged(const std::string &fileName, const ZipEntry &zipEntry) const;
+    // true if fileStat is still the file that was extracted, a file replaced or written since has another inode,
+    // size or mtime. the ctime is not compared, linking the file into a new code path changes it.
+    bool IsFileUnchanged(const std::string &fileName, const struct stat &fileStat) const;
+    void Add(const std::string &fileName, const ZipEntry &zipEntry);
+    // records the inode and mtime of the files once they are all written to codeDir, a file which can not be
+    // stat'ed is left out and extracted again next time.
+    void StampFiles(const std::string &codeDir);
+    // the file is synced by the caller together with the rest of codeDir, nothing is left behind on failure.
+    bool Save(const std::string &codeDir) const;
+    static bool IsManifestFile(const std::string &fileName);
+private:
+    struct ManifestItem {
+        uint32_t crc = 0;
+        uint32_t uncompressedSize = 0;
+        uint32_t compressedSize = 0;
+        uint16_t compressionMethod = 0;
+        uint64_t ino = 0;
+        int64_t mtimeSec = 0;
+        int64_t mtimeNsec = 0;
+    };
+
+    bool ParseLine(const std::string &line);
+
+    std::unordered_map<std::string, ManifestItem> items_;
+};
+} // OHOS
+#endif // OHOS_BUNDLE_HAP_MANIFEST_H
@@ -16,6 +16,7 @@
 #ifndef OHOS_BUNDLEMS_CLIENT_H
 #define OHOS_BUNDLEMS_CLIENT_H
 
+#include "bundle_daemon_interface.h"
 #include "ipc_skeleton.h"
 #include "nocopyable.h"
 #include "ohos_types.h"
@@ -26,6 +27,7 @@ public:
     explicit BundleMsClient(const SvcIdentity &svcIdentity);
     ~BundleMsClient() {};
     int32_t SendReply(int32_t result);
+    int32_t SendReply(int32_t result, const BdsExtractStats &stats);
 private:
     SvcIdentity svcIdentity_ {};
 };
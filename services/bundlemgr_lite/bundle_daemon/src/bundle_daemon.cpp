@@ -18,6 +18,7 @@
 #include <string>
 
 #include "bundle_daemon_log.h"
+#include "bundle_dedup_store.h"
 #include "ipc_skeleton.h"
 #include "ohos_errno.h"
 #include "ohos_init.h"
@@ -81,6 +82,7 @@ BOOL BundleDaemon::ServiceInitialize(Service *service, Identity identity)
     }
     BundleDaemon *bundleDaemon = static_cast<BundleDaemon *>(service);
     bundleDaemon->identity_ = identity;
+    BundleDedupStore::CollectAll();
     return TRUE;
 }
 
@@ -128,10 +130,21 @@ int32_t BundleDaemon::Invoke(IServerProxy *iProxy, int32_t funcId, void *origin,
     if (funcId >= EXTRACT_HAP && funcId < BDS_CMD_END) {
         ret = (BundleDaemon::invokeFuncs[funcId])(req);
     }
+    bool isExtract = (funcId == EXTRACT_HAP || funcId == EXTRACT_HAP_ARCHIVE || funcId == EXTRACT_HAP_UPDATE);
 #ifdef __LINUX__
     WriteInt32(reply, ret);
+    if (isExtract) {
+        const BdsExtractStats &stats = BundleDaemon::GetInstance().handler_.GetExtractStats();
+        WriteUint32(reply, stats.bytesRead);
+        WriteUint32(reply, stats.bytesWritten);
+        WriteUint32(reply, stats.fileCount);
+    }
     return ret;
 #else
+    if (isExtract) {
+        return BundleDaemon::GetInstance().bundleMsClient_->SendReply(ret,
+            BundleDaemon::GetInstance().handler_.GetExtractStats());
+    }
     return BundleDaemon::GetInstance().bundleMsClient_->SendReply(ret);
 #endif
 }
@@ -171,6 +184,52 @@ int32_t BundleDaemon::ExtractHapInvoke(IpcIo *req)
     return BundleDaemon::GetInstance().handler_.ExtractHap(hapPath.c_str(), codePath.c_str());
 }
 
+int32_t BundleDaemon::ExtractHapArchiveInvoke(IpcIo *req)
+{
+    std::string hapPath = "";
+    std::string codePath = "";
+    int32_t ret = ObtainStringFromIpc(req, hapPath, codePath);
+    if (ret != EC_SUCCESS) {
+        return ret;
+    }
+    return BundleDaemon::GetInstance().handler_.ExtractHapArchive(hapPath.c_str(), codePath.c_str());
+}
+
+int32_t BundleDaemon::ExtractHapUpdateInvoke(IpcIo *req)
+{
+    std::string hapPath = "";
+    std::string codePath = "";
+    int32_t ret = ObtainStringFromIpc(req, hapPath, codePath);
+    if (ret != EC_SUCCESS) {
+        return ret;
+    }
+    size_t len = 0;
+    const char *installedPath = reinterpret_cast<char *>(ReadString(req, &len));
+    if (installedPath == nullptr || len == 0) {
+        return EC_INVALID;
+    }
+    bool isArchiveMode = false;
+    ReadBool(req, &isArchiveMode);
+    return BundleDaemon::GetInstance().handler_.ExtractHapUpdate(hapPath.c_str(), codePath.c_str(), installedPath,
+        isArchiveMode);
+}
+
+int32_t BundleDaemon::ApplyHapPatchInvoke(IpcIo *req)
+{
+    std::string patchPath = "";
+    std::string hapPath = "";
+    int32_t ret = ObtainStringFromIpc(req, patchPath, hapPath);
+    if (ret != EC_SUCCESS) {
+        return ret;
+    }
+    size_t len = 0;
+    const char *baseCodePath = reinterpret_cast<char *>(ReadString(req, &len));
+    if (baseCodePath == nullptr || len == 0) {
+        return EC_INVALID;
+    }
+    return BundleDaemon::GetInstance().handler_.ApplyHapPatch(patchPath.c_str(), baseCodePath, hapPath.c_str());
+}
+
 int32_t BundleDaemon::RenameFileInvoke(IpcIo *req)
 {
     std::string oldFile = "";
@@ -220,6 +279,23 @@ int32_t BundleDaemon::StoreContentToFileInvoke(IpcIo *req)
     return ret;
 }
 
+int32_t BundleDaemon::AppendContentToFileInvoke(IpcIo *req)
+{
+    size_t len = 0;
+    const char *path = reinterpret_cast<char *>(ReadString(req, &len));
+    if (path == nullptr || len == 0) {
+        return EC_INVALID;
+    }
+    size_t buffLen = 0;
+    const char *buff = reinterpret_cast<char *>(ReadString(req, &buffLen));
+    if (buff == nullptr || buffLen == 0) {
+        return EC_INVALID;
+    }
+    bool isSync = true;
+    ReadBool(req, &isSync);
+    return BundleDaemon::GetInstance().handler_.AppendContentToFile(path, buff, buffLen, isSync);
+}
+
 int32_t BundleDaemon::MoveFileInvoke(IpcIo *req)
 {
     size_t len = 0;
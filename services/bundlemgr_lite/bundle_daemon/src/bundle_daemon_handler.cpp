@@ -18,10 +18,17 @@
 #include <climits>
 #include <cstring>
 #include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 #include "bundle_daemon_log.h"
+#include "bundle_dedup_store.h"
+#include "bundle_extract_writer.h"
 #include "bundle_file_utils.h"
+#include "bundle_hap_manifest.h"
 #include "extractor_util.h"
+#include "hap_patch.h"
 #include "ohos_errno.h"
 
 namespace OHOS {
@@ -36,20 +43,136 @@ const std::string SYSTEM_HAP_PATH = "/system/internal";
 const std::string THIRD_HAP_PATH = "/system/external";
 const std::string SDCARD = "/sdcard";
 const std::string STORAGE = "/storage";
+const std::string PROFILE_NAME = "config.json";
+const std::string RESOURCES_INDEX_NAME = "resources.index";
+const std::string SHARED_LIB_DIR = "shared_libs/";
+const std::string ARCHIVE_HAP_NAME = "archive.hap";
+// left for the directories and the metadata of the extracted files
+constexpr uint64_t EXTRACT_SPACE_MARGIN = 256 * 1024;
 }
 
 int32_t BundleDaemonHandler::ExtractHap(const char *hapPath, const char *codePath)
 {
+    return ExtractHapFiles(hapPath, codePath, false, nullptr);
+}
+
+int32_t BundleDaemonHandler::ExtractHapArchive(const char *hapPath, const char *codePath)
+{
+    return ExtractHapFiles(hapPath, codePath, true, nullptr);
+}
+
+int32_t BundleDaemonHandler::ExtractHapUpdate(const char *hapPath, const char *codePath, const char *installedPath,
+    bool isArchiveMode)
+{
+    if (!IsValideCodePath(installedPath)) {
+        return EC_INVALID;
+    }
+    return ExtractHapFiles(hapPath, codePath, isArchiveMode, installedPath);
+}
+
+const BdsExtractStats &BundleDaemonHandler::GetExtractStats() const
+{
+    return extractStats_;
+}
+
+int32_t BundleDaemonHandler::ApplyHapPatch(const char *patchPath, const char *baseCodePath, const char *hapPath)
+{
+    char realPatchPath[PATH_MAX + 1] = { '\0' };
+    if (patchPath == nullptr || realpath(patchPath, realPatchPath) == nullptr) {
+        PRINTE("BundleDaemonHandler", "realPath fail!");
+        return EC_INVALID;
+    }
+    if (!IsValideCodePath(baseCodePath) || !IsValideCodePath(hapPath)) {
+        return EC_INVALID;
+    }
+    HapPatch hapPatch(realPatchPath);
+    if (!hapPatch.Open()) {
+        PRINTE("BundleDaemonHandler", "open patch fail!");
+        return EC_INVALID;
+    }
+    if (!hapPatch.Apply(baseCodePath, hapPath)) {
+        PRINTE("BundleDaemonHandler", "apply patch fail!");
+        return EC_FAILURE;
+    }
+    return EC_SUCCESS;
+}
+
+bool BundleDaemonHandler::LinkUnchangedFile(const std::string &fileName, const std::string &installedDir,
+    const BundleHapManifest &installedManifest, BundleExtractWriter &extractWriter)
+{
+    std::string installedFile = installedDir + fileName;
+    struct stat fileStat;
+    // a file changed on disk since it was extracted is extracted again
+    if (lstat(installedFile.c_str(), &fileStat) != 0 || !installedManifest.IsFileUnchanged(fileName, fileStat)) {
+        return false;
+    }
+    return extractWriter.LinkFile(fileName, installedFile);
+}
+
+bool BundleDaemonHandler::IsArchiveResidentFile(const std::string &fileName)
+{
+    if (fileName == PROFILE_NAME || fileName.compare(0, SHARED_LIB_DIR.size(), SHARED_LIB_DIR) == 0) {
+        return true;
+    }
+    if (fileName == RESOURCES_INDEX_NAME) {
+        return true;
+    }
+    size_t pos = fileName.rfind(PATH_SEPARATOR);
+    return pos != std::string::npos && fileName.compare(pos + 1, std::string::npos, RESOURCES_INDEX_NAME) == 0;
+}
+
+bool BundleDaemonHandler::HasSpaceToExtract(const ExtractorUtil &extractorUtil, const std::string &codeDir,
+    bool isArchiveMode, const BundleHapManifest *installedManifest)
+{
+    uint64_t freeSize = 0;
+    uint64_t blockSize = 0;
+    if (!BundleFileUtils::GetFreeSpace(codeDir.c_str(), freeSize, blockSize) || blockSize == 0) {
+        // the preallocation of each file still fails before its content is written
+        return true;
+    }
+    uint64_t requiredSize = EXTRACT_SPACE_MARGIN;
+    const std::vector<ZipEntryName> &fileNames = extractorUtil.GetZipFileNames();
+    for (const auto &entryName : fileNames) {
+        const std::string fileName = entryName.ToString();
+        if (fileName.empty() || fileName.back() == PATH_SEPARATOR ||
+            (isArchiveMode && !IsArchiveResidentFile(fileName))) {
+            continue;
+        }
+        ZipEntry zipEntry;
+        if (!extractorUtil.GetEntry(fileName, zipEntry) ||
+            (installedManifest != nullptr && installedManifest->IsUnchanged(fileName, zipEntry))) {
+            continue;
+        }
+        // every file takes whole blocks
+        requiredSize += (static_cast<uint64_t>(zipEntry.uncompressedSize) + blockSize - 1) / blockSize * blockSize;
+    }
+    if (requiredSize > freeSize) {
+        PRINTE("BundleDaemonHandler", "no space to extract, required: %{public}llu, free: %{public}llu",
+            static_cast<unsigned long long>(requiredSize), static_cast<unsigned long long>(freeSize));
+        return false;
+    }
+    return true;
+}
+
+int32_t BundleDaemonHandler::ExtractHapFiles(const char *hapPath, const char *codePath, bool isArchiveMode,
+    const char *installedPath)
+{
+    extractStats_ = {};
     char realHapPath[PATH_MAX + 1] = { '\0' };
     if (hapPath == nullptr || realpath(hapPath, realHapPath) == nullptr) {
         PRINTE("BundleDaemonHandler", "realPath fail!");
         return EC_INVALID;
     }
     ExtractorUtil extractorUtil(realHapPath);
+    // the hap is read front to back once. Its signature may still be verified meanwhile, so the installer drops
+    // its pages from the cache once both are done
+    extractorUtil.SetReadHint(FILE_READ_HINT_SEQUENTIAL, false);
     if (!extractorUtil.Init()) {
         PRINTE("BundleDaemonHandler", "init fail!");
         return EC_NOINIT;
     }
+    // codePath is a temporary directory which is renamed into place only after the sync below
+    extractorUtil.SetSyncMode(SYNC_BY_CALLER);
 
     // check and mkdir code path
     if (!IsValideCodePath(codePath)) {
@@ -69,29 +192,95 @@ int32_t BundleDaemonHandler::ExtractHap(const char *hapPath, const char *codePat
         return EC_NODIR;
     }
 
+    BundleExtractWriter extractWriter(codeDir);
+    if (!extractWriter.Init()) {
+        PRINTE("BundleDaemonHandler", "init extract writer fail!");
+        return EC_NODIR;
+    }
+    BundleDedupStore dedupStore(extractorUtil, codeDir);
+    bool useDedupStore = dedupStore.Init();
+    // on update the files whose entries did not change are linked from the installed version, which stays
+    // untouched until the staging directory is renamed over it
+    std::string installedDir = (installedPath == nullptr) ? "" : std::string(installedPath);
+    if (!installedDir.empty() && installedDir.back() != PATH_SEPARATOR) {
+        installedDir += PATH_SEPARATOR;
+    }
+    BundleHapManifest installedManifest;
+    bool isIncremental = !installedDir.empty() && installedManifest.Load(installedDir);
+    // the install fails here rather than after writing most of the hap
+    if (!HasSpaceToExtract(extractorUtil, codeDir, isArchiveMode, isIncremental ? &installedManifest : nullptr)) {
+        return EC_NOSPACE;
+    }
+    BundleHapManifest manifest;
+    bool keepManifest = true;
+
     // unzip one by one
-    const std::vector<std::string> &fileNames = extractorUtil.GetZipFileNames();
-    for (const auto &fileName : fileNames) {
+    const std::vector<ZipEntryName> &fileNames = extractorUtil.GetZipFileNames();
+    for (const auto &entryName : fileNames) {
+        const std::string fileName = entryName.ToString();
+        if (fileName.empty()) {
+            continue;
+        }
         if (fileName.find("..") != std::string::npos) {
             PRINTE("BundleDaemonHandler", "zip file is invalid!");
             return EC_NODIR;
         }
-        if (fileName.back() == PATH_SEPARATOR) {
+        if (fileName.back() == PATH_SEPARATOR || (isArchiveMode && !IsArchiveResidentFile(fileName))) {
             continue;
         }
-        const std::string dir = BundleFileUtils::GetPathDir(fileName);
-        if (!dir.empty()) {
-            std::string fileDir = codeDir + dir;
-            if (!BundleFileUtils::MkRecursiveDir(fileDir.c_str(), false)) {
-                PRINTE("BundleDaemonHandler", "create other dir fail!");
-                return EC_NODIR;
-            }
+        ZipEntry zipEntry;
+        if (!extractorUtil.GetEntry(fileName, zipEntry)) {
+            PRINTE("BundleDaemonHandler", "get zip entry fail!");
+            return EC_NODIR;
         }
-        std::string filePath = codeDir + fileName;
-        if (!extractorUtil.ExtractFileToPath(filePath, fileName)) {
-            PRINTE("BundleDaemonHandler", "ExtractFileToPath fail!");
+        // a hap which ships a file of that name keeps it, its code path just has no manifest
+        keepManifest = keepManifest && !BundleHapManifest::IsManifestFile(fileName);
+        manifest.Add(fileName, zipEntry);
+        if (isIncremental && installedManifest.IsUnchanged(fileName, zipEntry) &&
+            LinkUnchangedFile(fileName, installedDir, installedManifest, extractWriter)) {
+            continue;
+        }
+        if (useDedupStore && dedupStore.LinkFromStore(fileName, extractWriter)) {
+            continue;
+        }
+        int32_t fd = extractWriter.CreateFile(fileName);
+        if (fd < 0) {
+            PRINTE("BundleDaemonHandler", "create file fail!");
+            return EC_NODIR;
+        }
+        // the final size is known, so the filesystem can allocate the file in one piece
+        if (!BundleFileUtils::PreallocateFile(fd, zipEntry.uncompressedSize)) {
+            close(fd);
+            return EC_NOSPACE;
+        }
+        bool result = extractorUtil.ExtractFileToFd(fd, fileName);
+        close(fd);
+        if (!result) {
+            PRINTE("BundleDaemonHandler", "ExtractFileToFd fail!");
             return EC_NODIR;
         }
+        extractStats_.bytesRead += zipEntry.compressedSize;
+        extractStats_.bytesWritten += zipEntry.uncompressedSize;
+        extractStats_.fileCount++;
+        if (useDedupStore) {
+            dedupStore.AddToStore(fileName, codeDir + fileName);
+        }
+    }
+    // the remaining entries are served from the archive itself, which is kept next to the extracted files
+    if (isArchiveMode && !BundleFileUtils::LinkOrCopyFile(realHapPath, (codeDir + ARCHIVE_HAP_NAME).c_str())) {
+        PRINTE("BundleDaemonHandler", "keep hap archive fail!");
+        return EC_NODIR;
+    }
+    if (keepManifest) {
+        manifest.StampFiles(codeDir);
+    }
+    if (keepManifest && !manifest.Save(codeDir)) {
+        // the next update of this bundle extracts everything again
+        PRINTW("BundleDaemonHandler", "save hap manifest fail!");
+    }
+    if (!BundleFileUtils::SyncDir(codeDir.c_str())) {
+        PRINTE("BundleDaemonHandler", "sync codePath fail!");
+        return EC_FAILURE;
     }
     return EC_SUCCESS;
 }
@@ -108,10 +297,16 @@ int32_t BundleDaemonHandler::RenameFile(const char *oldFile, const char *newFile
         PRINTE("BundleDaemonHandler", "file path is invalid");
         return EC_INVALID;
     }
+    // an update replaces the old code path, drop the store objects only it used
+    std::vector<std::string> objects;
+    if (IsValideCodePath(newFile)) {
+        objects = BundleDedupStore::GetLinkedObjects(newFile);
+    }
     if (!BundleFileUtils::RenameFile(realOldPath, newFile)) {
         PRINTE("BundleDaemonHandler", "rename dir fail");
         return EC_NODIR;
     }
+    BundleDedupStore::Collect(objects);
     return EC_SUCCESS;
 }
 
@@ -155,7 +350,13 @@ int32_t BundleDaemonHandler::CreateDataDirectory(const char *dataPath, int32_t u
 
 int32_t BundleDaemonHandler::RemoveInstallDirectory(const char *codePath, const char *dataPath, bool keepData)
 {
-    bool result = IsValideCodePath(codePath) && BundleFileUtils::RemoveFile(codePath);
+    bool result = IsValideCodePath(codePath);
+    if (result) {
+        // an object is only removed once nothing links it, so a partly removed code path is collected as well
+        std::vector<std::string> objects = BundleDedupStore::GetLinkedObjects(codePath);
+        result = BundleFileUtils::RemoveFile(codePath);
+        BundleDedupStore::Collect(objects);
+    }
     if (!keepData) {
         result = IsValideDataPath(dataPath) && BundleFileUtils::RemoveFile(dataPath) && result;
     }
@@ -189,6 +390,29 @@ int32_t BundleDaemonHandler::StoreContentToFile(const char *filePath, const void
     return EC_SUCCESS;
 }
 
+int32_t BundleDaemonHandler::AppendContentToFile(const char *filePath, const void *buffer, uint32_t size,
+    bool isSync)
+{
+    if (!IsValideJsonPath(filePath)) {
+        PRINTE("BundleDaemonHandler", "append content file path invalid");
+        return EC_NOFILE;
+    }
+    const std::string dir = BundleFileUtils::GetPathDir(filePath);
+    if (dir.empty()) {
+        PRINTE("BundleDaemonHandler", "append content file dir invalid");
+        return EC_NODIR;
+    }
+    if (!BundleFileUtils::IsExistDir(dir.c_str()) && !BundleFileUtils::MkRecursiveDir(dir.c_str(), true)) {
+        PRINTE("BundleDaemonHandler", "mkdir content json path fail");
+        return EC_NODIR;
+    }
+    if (!BundleFileUtils::AppendFile(filePath, buffer, size, isSync)) {
+        PRINTE("BundleDaemonHandler", "append content to file fail");
+        return EC_FAILURE;
+    }
+    return EC_SUCCESS;
+}
+
 int32_t BundleDaemonHandler::MoveFile(const char *oldFile, const char *newFile)
 {
     char realOldPath[PATH_MAX + 1] = { '\0' };
@@ -249,7 +473,14 @@ int32_t BundleDaemonHandler::RemoveFile(const char *filePath)
         PRINTE("BundleDaemonHandler", "file path is invalid");
         return EC_INVALID;
     }
-    if (!BundleFileUtils::RemoveFile(realFilePath)) {
+    // a failed install removes its temporary code path, which may have added store objects
+    std::vector<std::string> objects;
+    if (IsValideCodePath(realFilePath)) {
+        objects = BundleDedupStore::GetLinkedObjects(realFilePath);
+    }
+    bool result = BundleFileUtils::RemoveFile(realFilePath);
+    BundleDedupStore::Collect(objects);
+    if (!result) {
         PRINTE("BundleDaemonHandler", "clear content to file fail");
         return EC_NODIR;
     }
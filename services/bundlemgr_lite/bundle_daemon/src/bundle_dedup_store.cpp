@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_dedup_store.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <ostream>
+#include <streambuf>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bundle_daemon_log.h"
+#include "bundle_file_utils.h"
+#include "zlib.h"
+
+namespace OHOS {
+namespace {
+const char *STORE_PATH = "/storage/app/store/";
+// small files are not worth a store object and a link
+constexpr uint32_t MIN_DEDUP_SIZE = 4096;
+// different contents with the same crc32 and size get their own object, up to this many
+constexpr uint32_t MAX_OBJECTS_PER_KEY = 4;
+constexpr uint32_t OBJECT_PREFIX_LEN = 32;
+constexpr size_t COMPARE_BUFFER_SIZE = 4096;
+
+// compares what is written to it with the content of fd, writing fails at the first difference.
+class FdCompareBuf : public std::streambuf {
+public:
+    explicit FdCompareBuf(int32_t fd) : fd_(fd) {}
+    ~FdCompareBuf() override = default;
+
+    bool IsSame(off_t size) const
+    {
+        return !isDifferent_ && offset_ == size;
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        char c = traits_type::to_char_type(ch);
+        return (xsputn(&c, 1) == 1) ? ch : traits_type::eof();
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize count) override
+    {
+        char buffer[COMPARE_BUFFER_SIZE];
+        std::streamsize compared = 0;
+        while (!isDifferent_ && compared < count) {
+            size_t len = static_cast<size_t>(count - compared);
+            len = (len > sizeof(buffer)) ? sizeof(buffer) : len;
+            ssize_t readLen = pread(fd_, buffer, len, offset_);
+            if (readLen < 0 && errno == EINTR) {
+                continue;
+            }
+            if (readLen <= 0 || memcmp(buffer, s + compared, static_cast<size_t>(readLen)) != 0) {
+                isDifferent_ = true;
+                break;
+            }
+            offset_ += readLen;
+            compared += readLen;
+        }
+        return isDifferent_ ? 0 : compared;
+    }
+
+private:
+    int32_t fd_;
+    off_t offset_ = 0;
+    bool isDifferent_ = false;
+};
+
+bool GetFileCrc(const std::string &path, uint32_t &crc)
+{
+    int32_t fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[COMPARE_BUFFER_SIZE];
+    uLong fileCrc = crc32(0L, Z_NULL, 0);
+    ssize_t readLen = 0;
+    while ((readLen = read(fd, buffer, sizeof(buffer))) != 0) {
+        if (readLen < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readLen < 0) {
+            close(fd);
+            return false;
+        }
+        fileCrc = crc32(fileCrc, reinterpret_cast<const Bytef *>(buffer), static_cast<uInt>(readLen));
+    }
+    close(fd);
+    crc = static_cast<uint32_t>(fileCrc);
+    return true;
+}
+}
+
+BundleDedupStore::BundleDedupStore(const ExtractorUtil &extractorUtil, const std::string &codeDir)
+    : extractorUtil_(extractorUtil), codeDir_(codeDir) {}
+
+bool BundleDedupStore::Init()
+{
+#ifdef BUNDLE_DAEMON_DEDUP_STORE
+    if (!BundleFileUtils::MkRecursiveDir(STORE_PATH, false)) {
+        PRINTW("BundleDedupStore", "create store dir fail");
+        return false;
+    }
+    struct stat storeStat = {};
+    struct stat codeStat = {};
+    if (stat(STORE_PATH, &storeStat) != 0 || stat(codeDir_.c_str(), &codeStat) != 0) {
+        return false;
+    }
+    // hard links can not cross filesystems, e.g. for bundles installed to the sdcard
+    return storeStat.st_dev == codeStat.st_dev;
+#else
+    return false;
+#endif
+}
+
+bool BundleDedupStore::GetObjectPrefix(const std::string &fileName, ZipEntry &zipEntry, std::string &prefix) const
+{
+    if (!extractorUtil_.GetEntry(fileName, zipEntry) || zipEntry.uncompressedSize < MIN_DEDUP_SIZE) {
+        return false;
+    }
+    char key[OBJECT_PREFIX_LEN] = { '\0' };
+    if (snprintf(key, sizeof(key), "%08x_%u_", zipEntry.crc, zipEntry.uncompressedSize) < 0) {
+        return false;
+    }
+    prefix = std::string(STORE_PATH) + key;
+    return true;
+}
+
+bool BundleDedupStore::IsSameContent(const std::string &fileName, const ZipEntry &zipEntry,
+    const std::string &objectPath) const
+{
+    int32_t fd = open(objectPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat objectStat = {};
+    bool result = (fstat(fd, &objectStat) == 0) &&
+        (objectStat.st_size == static_cast<off_t>(zipEntry.uncompressedSize));
+    if (result) {
+        // the entry is still inflated and crc checked, only writing it is skipped
+        FdCompareBuf compareBuf(fd);
+        std::ostream compareStream(&compareBuf);
+        result = extractorUtil_.ExtractFileByName(fileName, compareStream) && compareBuf.IsSame(objectStat.st_size);
+    }
+    close(fd);
+    return result;
+}
+
+bool BundleDedupStore::LinkFromStore(const std::string &fileName, BundleExtractWriter &writer) const
+{
+    ZipEntry zipEntry;
+    std::string prefix;
+    if (!GetObjectPrefix(fileName, zipEntry, prefix)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < MAX_OBJECTS_PER_KEY; i++) {
+        std::string objectPath = prefix + std::to_string(i);
+        if (!BundleFileUtils::IsExistFile(objectPath.c_str())) {
+            return false;
+        }
+        if (IsSameContent(fileName, zipEntry, objectPath)) {
+            return writer.LinkFile(fileName, objectPath);
+        }
+    }
+    return false;
+}
+
+void BundleDedupStore::AddToStore(const std::string &fileName, const std::string &filePath) const
+{
+    ZipEntry zipEntry;
+    std::string prefix;
+    if (!GetObjectPrefix(fileName, zipEntry, prefix)) {
+        return;
+    }
+    for (uint32_t i = 0; i < MAX_OBJECTS_PER_KEY; i++) {
+        std::string objectPath = prefix + std::to_string(i);
+        if (link(filePath.c_str(), objectPath.c_str()) == 0) {
+            return;
+        }
+        if (errno != EEXIST) {
+            PRINTW("BundleDedupStore", "add store object fail, error: %{public}d", errno);
+            return;
+        }
+    }
+}
+
+std::vector<std::string> BundleDedupStore::GetLinkedObjects(const char *path)
+{
+    std::vector<std::string> objects;
+#ifdef BUNDLE_DAEMON_DEDUP_STORE
+    if (path != nullptr) {
+        FindLinkedObjects(path, objects);
+    }
+#endif
+    return objects;
+}
+
+void BundleDedupStore::FindLinkedObjects(const std::string &path, std::vector<std::string> &objects)
+{
+    struct stat fileStat = {};
+    if (lstat(path.c_str(), &fileStat) != 0) {
+        return;
+    }
+    if (S_ISDIR(fileStat.st_mode)) {
+        DIR *dir = opendir(path.c_str());
+        if (dir == nullptr) {
+            return;
+        }
+        struct dirent *dp = nullptr;
+        while ((dp = readdir(dir)) != nullptr) {
+            if (strcmp(dp->d_name, ".") != 0 && strcmp(dp->d_name, "..") != 0) {
+                FindLinkedObjects(path + "/" + dp->d_name, objects);
+            }
+        }
+        closedir(dir);
+        return;
+    }
+    // a file only this tree links was never added to the store
+    if (!S_ISREG(fileStat.st_mode) || fileStat.st_nlink <= 1 || fileStat.st_size < MIN_DEDUP_SIZE ||
+        fileStat.st_size > static_cast<off_t>(UINT32_MAX)) {
+        return;
+    }
+    uint32_t crc = 0;
+    char key[OBJECT_PREFIX_LEN] = { '\0' };
+    if (!GetFileCrc(path, crc) || snprintf(key, sizeof(key), "%08x_%u_", crc,
+        static_cast<uint32_t>(fileStat.st_size)) < 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < MAX_OBJECTS_PER_KEY; i++) {
+        std::string objectPath = std::string(STORE_PATH) + key + std::to_string(i);
+        struct stat objectStat = {};
+        if (lstat(objectPath.c_str(), &objectStat) != 0) {
+            return;
+        }
+        if (objectStat.st_dev == fileStat.st_dev && objectStat.st_ino == fileStat.st_ino) {
+            objects.push_back(objectPath);
+            return;
+        }
+    }
+}
+
+void BundleDedupStore::Collect(const std::vector<std::string> &objects)
+{
+    for (const auto &objectPath : objects) {
+        struct stat objectStat = {};
+        // only the store itself links the object, no installed bundle uses it anymore
+        if (lstat(objectPath.c_str(), &objectStat) == 0 && objectStat.st_nlink <= 1 &&
+            unlink(objectPath.c_str()) != 0) {
+            PRINTW("BundleDedupStore", "remove store object fail, error: %{public}d", errno);
+        }
+    }
+}
+
+void BundleDedupStore::CollectAll()
+{
+#ifdef BUNDLE_DAEMON_DEDUP_STORE
+    DIR *dir = opendir(STORE_PATH);
+    if (dir == nullptr) {
+        return;
+    }
+    int32_t dirFd = dirfd(dir);
+    struct dirent *dp = nullptr;
+    while ((dp = readdir(dir)) != nullptr) {
+        struct stat objectStat = {};
+        if (fstatat(dirFd, dp->d_name, &objectStat, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISREG(objectStat.st_mode)) {
+            continue;
+        }
+        // only the store itself links the object, no installed bundle uses it anymore
+        if (objectStat.st_nlink <= 1 && unlinkat(dirFd, dp->d_name, 0) != 0) {
+            PRINTW("BundleDedupStore", "remove store object fail, error: %{public}d", errno);
+        }
+    }
+    closedir(dir);
+#endif
+}
+} // OHOS
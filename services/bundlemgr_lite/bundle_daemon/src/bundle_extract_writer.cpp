@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_extract_writer.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bundle_daemon_log.h"
+#include "bundle_file_utils.h"
+
+namespace OHOS {
+namespace {
+constexpr size_t MAX_OPEN_DIR_FDS = 32;
+constexpr mode_t EXTRACT_DIR_MODE = S_IRWXU | S_IRWXG | S_IXOTH;
+constexpr mode_t EXTRACT_FILE_MODE = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+}
+
+BundleExtractWriter::BundleExtractWriter(const std::string &rootDir) : rootDir_(rootDir) {}
+
+BundleExtractWriter::~BundleExtractWriter()
+{
+    CloseDirs();
+    if (rootFd_ >= 0) {
+        close(rootFd_);
+        rootFd_ = -1;
+    }
+}
+
+bool BundleExtractWriter::Init()
+{
+    rootFd_ = open(rootDir_.c_str(), O_RDONLY | O_DIRECTORY);
+    if (rootFd_ < 0) {
+        PRINTE("BundleExtractWriter", "open root dir fail, error: %{public}d", errno);
+        return false;
+    }
+    return true;
+}
+
+void BundleExtractWriter::CloseDirs()
+{
+    for (const auto &dirFd : dirFds_) {
+        close(dirFd.second);
+    }
+    dirFds_.clear();
+}
+
+int32_t BundleExtractWriter::OpenDir(const std::string &relativeDir)
+{
+    if (relativeDir.empty()) {
+        return rootFd_;
+    }
+    auto iter = dirFds_.find(relativeDir);
+    if (iter != dirFds_.end()) {
+        return iter->second;
+    }
+
+    // relativeDir ends with a separator, split it into parent dir and the last component
+    std::string parentDir = BundleFileUtils::GetPathDir(relativeDir.substr(0, relativeDir.size() - 1));
+    int32_t parentFd = OpenDir(parentDir);
+    if (parentFd < 0) {
+        return -1;
+    }
+    std::string name = relativeDir.substr(parentDir.size(), relativeDir.size() - parentDir.size() - 1);
+    if (name.empty() || name == ".") {
+        return parentFd;
+    }
+    if (mkdirat(parentFd, name.c_str(), EXTRACT_DIR_MODE) != 0 && errno != EEXIST) {
+        PRINTE("BundleExtractWriter", "mkdir fail, error: %{public}d", errno);
+        return -1;
+    }
+    int32_t fd = openat(parentFd, name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    if (fd < 0) {
+        PRINTE("BundleExtractWriter", "open dir fail, error: %{public}d", errno);
+        return -1;
+    }
+    dirFds_[relativeDir] = fd;
+    return fd;
+}
+
+int32_t BundleExtractWriter::OpenParentDir(const std::string &relativePath, std::string &name)
+{
+    if (rootFd_ < 0 || relativePath.empty() || relativePath.find("..") != std::string::npos) {
+        return -1;
+    }
+    // entry names are always relative to the code path, even if the zip stores a leading separator
+    size_t start = relativePath.find_first_not_of(PATH_SEPARATOR);
+    if (start == std::string::npos) {
+        return -1;
+    }
+    std::string path = relativePath.substr(start);
+    if (dirFds_.size() >= MAX_OPEN_DIR_FDS) {
+        CloseDirs();
+    }
+
+    std::string dir = BundleFileUtils::GetPathDir(path);
+    int32_t dirFd = OpenDir(dir);
+    if (dirFd < 0) {
+        return -1;
+    }
+    name = path.substr(dir.size());
+    return dirFd;
+}
+
+int32_t BundleExtractWriter::CreateFile(const std::string &relativePath)
+{
+    std::string name;
+    int32_t dirFd = OpenParentDir(relativePath, name);
+    if (dirFd < 0) {
+        return -1;
+    }
+    int32_t fd = openat(dirFd, name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_NOFOLLOW, EXTRACT_FILE_MODE);
+    if (fd < 0) {
+        PRINTE("BundleExtractWriter", "create file fail, error: %{public}d", errno);
+    }
+    return fd;
+}
+
+bool BundleExtractWriter::LinkFile(const std::string &relativePath, const std::string &sourceFile)
+{
+    std::string name;
+    int32_t dirFd = OpenParentDir(relativePath, name);
+    if (dirFd < 0) {
+        return false;
+    }
+    if (linkat(AT_FDCWD, sourceFile.c_str(), dirFd, name.c_str(), 0) != 0) {
+        PRINTW("BundleExtractWriter", "link file fail, error: %{public}d", errno);
+        return false;
+    }
+    return true;
+}
+} // OHOS
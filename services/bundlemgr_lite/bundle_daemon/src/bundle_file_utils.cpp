@@ -15,16 +15,70 @@
 
 #include "bundle_file_utils.h"
 
+#include <cerrno>
 #include <climits>
 #include <dirent.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <unistd.h>
+#ifdef __LINUX__
+#include <sys/sendfile.h>
+#endif
 
 #include "bundle_daemon_log.h"
 #include "securec.h"
 
 namespace OHOS {
+namespace {
+constexpr uint32_t COPY_BUFFER_SIZE = 16 * 1024;
+
+bool CopyFileContent(int32_t srcFd, int32_t destFd, off_t size)
+{
+    off_t offset = 0;
+#ifdef __LINUX__
+    while (offset < size) {
+        ssize_t sent = sendfile(destFd, srcFd, &offset, static_cast<size_t>(size - offset));
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            break;
+        }
+    }
+    if (offset == size) {
+        return true;
+    }
+    if (lseek(srcFd, offset, SEEK_SET) != offset || lseek(destFd, offset, SEEK_SET) != offset) {
+        return false;
+    }
+#endif
+    char buffer[COPY_BUFFER_SIZE];
+    while (offset < size) {
+        ssize_t readLen = read(srcFd, buffer, sizeof(buffer));
+        if (readLen < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readLen <= 0) {
+            return false;
+        }
+        ssize_t written = 0;
+        while (written < readLen) {
+            ssize_t ret = write(destFd, buffer + written, static_cast<size_t>(readLen - written));
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ret <= 0) {
+                return false;
+            }
+            written += ret;
+        }
+        offset += readLen;
+    }
+    return true;
+}
+}
+
 bool BundleFileUtils::IsExistDir(const char *path)
 {
     if (path == nullptr) {
@@ -147,6 +201,145 @@ bool BundleFileUtils::WriteFile(const char *file, const void *buffer, uint32_t s
     return true;
 }
 
+bool BundleFileUtils::AppendFile(const char *file, const void *buffer, uint32_t size, bool isSync)
+{
+    if (file == nullptr || buffer == nullptr || size == 0) {
+        return false;
+    }
+
+    int32_t fd = open(file, O_WRONLY | O_CREAT | O_APPEND, S_IREAD | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        return false;
+    }
+
+    const char *data = static_cast<const char *>(buffer);
+    uint32_t written = 0;
+    while (written < size) {
+        ssize_t ret = write(fd, data + written, size - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            break;
+        }
+        written += static_cast<uint32_t>(ret);
+    }
+    // fdatasync flushes every earlier unsynced append of the file too
+    if (written != size || (isSync && fdatasync(fd) != 0)) {
+        // a torn append would hide every later append from a reader which stops at the first bad record
+        if (ftruncate(fd, fileStat.st_size) == 0) {
+            (void) fdatasync(fd);
+        }
+        close(fd);
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+bool BundleFileUtils::SyncDir(const char *dir)
+{
+    if (dir == nullptr) {
+        return false;
+    }
+
+    int32_t fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return false;
+    }
+    // flush all data written under dir with one call instead of one fsync per file
+#ifdef __LINUX__
+    if (syncfs(fd) != 0) {
+        sync();
+    }
+#else
+    sync();
+#endif
+    bool result = (fsync(fd) == 0);
+    close(fd);
+    return result;
+}
+
+bool BundleFileUtils::LinkOrCopyFile(const char *oldFile, const char *newFile)
+{
+    if (oldFile == nullptr || newFile == nullptr) {
+        return false;
+    }
+    if (link(oldFile, newFile) == 0) {
+        return true;
+    }
+    // the source may live on another (or a read-only) filesystem, fall back to one sequential copy
+    if (errno != EXDEV && errno != EPERM) {
+        PRINTE("BundleFileUtils", "link file fail, error: %{public}d", errno);
+        return false;
+    }
+
+    int32_t srcFd = open(oldFile, O_RDONLY);
+    if (srcFd < 0) {
+        return false;
+    }
+    struct stat buf = {};
+    if (fstat(srcFd, &buf) != 0 || !S_ISREG(buf.st_mode)) {
+        close(srcFd);
+        return false;
+    }
+    int32_t destFd = open(newFile, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (destFd < 0) {
+        close(srcFd);
+        return false;
+    }
+    bool result = PreallocateFile(destFd, static_cast<uint64_t>(buf.st_size)) &&
+        CopyFileContent(srcFd, destFd, buf.st_size);
+    close(srcFd);
+    close(destFd);
+    if (!result) {
+        PRINTE("BundleFileUtils", "copy file fail");
+        (void) remove(newFile);
+    }
+    return result;
+}
+
+bool BundleFileUtils::PreallocateFile(int32_t fd, uint64_t size)
+{
+    if (fd < 0 || size == 0) {
+        return fd >= 0;
+    }
+#if defined(__LINUX__) && defined(FALLOC_FL_KEEP_SIZE)
+    // not posix_fallocate, which falls back to writing zeros and so writes every byte twice on flash.
+    // KEEP_SIZE leaves the file empty, a failed extraction does not leave a zero filled tail behind.
+    int32_t ret;
+    do {
+        ret = fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size));
+    } while (ret != 0 && errno == EINTR);
+    if (ret != 0 && errno == ENOSPC) {
+        PRINTE("BundleFileUtils", "preallocate %{public}llu bytes fail, no space",
+            static_cast<unsigned long long>(size));
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool BundleFileUtils::GetFreeSpace(const char *dir, uint64_t &freeSize, uint64_t &blockSize)
+{
+    if (dir == nullptr) {
+        return false;
+    }
+    struct statvfs fsStat = {};
+    if (statvfs(dir, &fsStat) != 0) {
+        PRINTE("BundleFileUtils", "statvfs fail, error: %{public}d", errno);
+        return false;
+    }
+    blockSize = (fsStat.f_frsize != 0) ? fsStat.f_frsize : fsStat.f_bsize;
+    freeSize = static_cast<uint64_t>(fsStat.f_bavail) * blockSize;
+    return true;
+}
+
 bool BundleFileUtils::IsValidPath(const std::string &rootDir, const std::string &path)
 {
     if (rootDir.find(PATH_SEPARATOR) != 0 || rootDir.rfind(PATH_SEPARATOR) != (rootDir.size() - 1) ||
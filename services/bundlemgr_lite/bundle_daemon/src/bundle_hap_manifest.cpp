@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_hap_manifest.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bundle_daemon_log.h"
+
+namespace OHOS {
+namespace {
+const std::string MANIFEST_NAME = ".hap_manifest";
+// a hap with this many files is far beyond anything installed on these devices
+constexpr off_t MAX_MANIFEST_SIZE = 4 * 1024 * 1024;
+constexpr size_t MAX_LINE_HEAD_LEN = 128;
+}
+
+bool BundleHapManifest::IsManifestFile(const std::string &fileName)
+{
+    return fileName == MANIFEST_NAME;
+}
+
+bool BundleHapManifest::Load(const std::string &codeDir)
+{
+    items_.clear();
+    int32_t fd = open((codeDir + MANIFEST_NAME).c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0 ||
+        fileStat.st_size > MAX_MANIFEST_SIZE) {
+        close(fd);
+        return false;
+    }
+    std::string content(static_cast<size_t>(fileStat.st_size), '\0');
+    size_t readLen = 0;
+    while (readLen < content.size()) {
+        ssize_t len = read(fd, &content[readLen], content.size() - readLen);
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len <= 0) {
+            break;
+        }
+        readLen += static_cast<size_t>(len);
+    }
+    close(fd);
+    if (readLen != content.size() || content.back() != '\n') {
+        PRINTW("BundleHapManifest", "manifest is incomplete");
+        return false;
+    }
+
+    size_t start = 0;
+    while (start < content.size()) {
+        size_t end = content.find('\n', start);
+        if (!ParseLine(content.substr(start, end - start))) {
+            PRINTW("BundleHapManifest", "manifest is invalid");
+            items_.clear();
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+bool BundleHapManifest::ParseLine(const std::string &line)
+{
+    ManifestItem item;
+    unsigned int method = 0;
+    unsigned long long ino = 0;
+    long long mtimeSec = 0;
+    long long mtimeNsec = 0;
+    int nameOffset = 0;
+    // a manifest of an older format fails here, the update then extracts every file
+    if (sscanf(line.c_str(), "%8x %u %u %u %llu %lld %lld %n", &item.crc, &item.uncompressedSize,
+        &item.compressedSize, &method, &ino, &mtimeSec, &mtimeNsec, &nameOffset) != 7 || nameOffset <= 0 ||
+        static_cast<size_t>(nameOffset) >= line.size()) {
+        return false;
+    }
+    item.compressionMethod = static_cast<uint16_t>(method);
+    item.ino = static_cast<uint64_t>(ino);
+    item.mtimeSec = static_cast<int64_t>(mtimeSec);
+    item.mtimeNsec = static_cast<int64_t>(mtimeNsec);
+    items_[line.substr(static_cast<size_t>(nameOffset))] = item;
+    return true;
+}
+
+bool BundleHapManifest::IsUnchanged(const std::string &fileName, const ZipEntry &zipEntry) const
+{
+    auto iter = items_.find(fileName);
+    if (iter == items_.end()) {
+        return false;
+    }
+    const ManifestItem &item = iter->second;
+    return item.crc == zipEntry.crc && item.uncompressedSize == zipEntry.uncompressedSize &&
+        item.compressedSize == zipEntry.compressedSize && item.compressionMethod == zipEntry.compressionMethod;
+}
+
+bool BundleHapManifest::IsFileUnchanged(const std::string &fileName, const struct stat &fileStat) const
+{
+    auto iter = items_.find(fileName);
+    if (iter == items_.end()) {
+        return false;
+    }
+    const ManifestItem &item = iter->second;
+    return S_ISREG(fileStat.st_mode) && fileStat.st_size == static_cast<off_t>(item.uncompressedSize) &&
+        static_cast<uint64_t>(fileStat.st_ino) == item.ino &&
+        static_cast<int64_t>(fileStat.st_mtim.tv_sec) == item.mtimeSec &&
+        static_cast<int64_t>(fileStat.st_mtim.tv_nsec) == item.mtimeNsec;
+}
+
+void BundleHapManifest::Add(const std::string &fileName, const ZipEntry &zipEntry)
+{
+    // such a name can not be written as one line, the file is simply extracted again next time
+    if (fileName.empty() || fileName.find('\n') != std::string::npos || fileName.front() == ' ') {
+        return;
+    }
+    ManifestItem item;
+    item.crc = zipEntry.crc;
+    item.uncompressedSize = zipEntry.uncompressedSize;
+    item.compressedSize = zipEntry.compressedSize;
+    item.compressionMethod = zipEntry.compressionMethod;
+    items_[fileName] = item;
+}
+
+void BundleHapManifest::StampFiles(const std::string &codeDir)
+{
+    for (auto iter = items_.begin(); iter != items_.end();) {
+        struct stat fileStat;
+        if (lstat((codeDir + iter->first).c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+            iter = items_.erase(iter);
+            continue;
+        }
+        iter->second.ino = static_cast<uint64_t>(fileStat.st_ino);
+        iter->second.mtimeSec = static_cast<int64_t>(fileStat.st_mtim.tv_sec);
+        iter->second.mtimeNsec = static_cast<int64_t>(fileStat.st_mtim.tv_nsec);
+        ++iter;
+    }
+}
+
+bool BundleHapManifest::Save(const std::string &codeDir) const
+{
+    std::string content;
+    char head[MAX_LINE_HEAD_LEN] = { 0 };
+    for (const auto &iter : items_) {
+        const ManifestItem &item = iter.second;
+        int len = snprintf(head, sizeof(head), "%08x %u %u %u %llu %lld %lld ", item.crc, item.uncompressedSize,
+            item.compressedSize, static_cast<unsigned int>(item.compressionMethod),
+            static_cast<unsigned long long>(item.ino), static_cast<long long>(item.mtimeSec),
+            static_cast<long long>(item.mtimeNsec));
+        if (len <= 0 || static_cast<size_t>(len) >= sizeof(head)) {
+            return false;
+        }
+        content.append(head, static_cast<size_t>(len));
+        content += iter.first;
+        content += '\n';
+    }
+    if (content.empty()) {
+        return true;
+    }
+
+    std::string manifestPath = codeDir + MANIFEST_NAME;
+    int32_t fd = open(manifestPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        PRINTE("BundleHapManifest", "create manifest fail, error: %{public}d", errno);
+        return false;
+    }
+    size_t written = 0;
+    while (written < content.size()) {
+        ssize_t len = write(fd, content.data() + written, content.size() - written);
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len <= 0) {
+            break;
+        }
+        written += static_cast<size_t>(len);
+    }
+    close(fd);
+    if (written != content.size()) {
+        PRINTE("BundleHapManifest", "write manifest fail");
+        unlink(manifestPath.c_str());
+        return false;
+    }
+    return true;
+}
+} // OHOS
@@ -34,4 +34,19 @@ int32 BundleMsClient::SendReply(int32 result)
     option.flags = TF_OP_ASYNC;
     return SendRequest(svcIdentity_, BDS_CALLBACK, &request, nullptr, option, nullptr);
 }
+
+int32 BundleMsClient::SendReply(int32 result, const BdsExtractStats &stats)
+{
+    IpcIo request;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&request, data, MAX_IO_SIZE, 0);
+    WriteInt32(&request, result);
+    WriteUint32(&request, stats.bytesRead);
+    WriteUint32(&request, stats.bytesWritten);
+    WriteUint32(&request, stats.fileCount);
+    MessageOption option;
+    MessageOptionInit(&option);
+    option.flags = TF_OP_ASYNC;
+    return SendRequest(svcIdentity_, BDS_CALLBACK, &request, nullptr, option, nullptr);
+}
 } // OHOS
@@ -119,6 +119,8 @@ const char GRANTTIME_ALWAYS[] = "always";
 // shared lib path
 const char SHARED_LIB_NAME[] = "shared_libs";
 const char SHARED_LIB_PATH[] = "/storage/app/libs";
+// hap kept in the module code path by archive install mode
+const char ARCHIVE_HAP_NAME[] = "archive.hap";
 
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
 const char DEFAULT_DEVICE_TYPE[] = "smartVision";
@@ -131,8 +133,19 @@ const char SYSTEM_BUNDLE_PATH[] = "/system/internal";
 const char THIRD_SYSTEM_BUNDLE_PATH[] = "/system/external";
 const char UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON[] = "/storage/app/etc/uninstalled_delbundle.json";
 const char THIRD_SYSTEM_BUNDLE_JSON[] = "/storage/app/etc/third_system_bundle.json";
+// signature infos of verified haps, see HapVerifyCache
+const char HAP_VERIFY_CACHE_JSON[] = "/storage/app/etc/hap_verify_cache.json";
+// committed changes of the install records, see InstallJournal
+const char INSTALL_JOURNAL_PATH[] = "/storage/app/etc/install_journal.log";
+// the registry as of the last committed change, see BundleRegistrySnapshot
+const char REGISTRY_SNAPSHOT_PATH[] = "/storage/app/etc/bundle_registry.snapshot";
+// install records, uids and third system bundles, see InstallRecordStore
+const char INSTALL_RECORD_STORE_PATH[] = "/storage/app/etc/install_record.store";
+// a file replaced by BundleUtil::StoreContentInChunks is written here first
+const char TMP_FILE_SUFFIX[] = ".tmp";
 const char UID_GID_MAP[] = "uid_gid_map";
 const char INSTALL_FILE_SUFFIX[] = ".hap";
+const char PATCH_FILE_SUFFIX[] = ".hpatch";
 // uid and gid
 const int8_t INVALID_UID = -1;
 const int8_t INVALID_GID = -1;
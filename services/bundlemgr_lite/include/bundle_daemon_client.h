@@ -18,6 +18,7 @@
 
 #include <semaphore.h>
 
+#include "bundle_daemon_interface.h"
 #include "ohos_errno.h"
 #include "iproxy_client.h"
 #include "ipc_skeleton.h"
@@ -33,15 +34,21 @@ public:
         return instance;
     }
     bool Initialize();
-    int32_t ExtractHap(const char *hapFile, const char *codePath);
+    int32_t ExtractHap(const char *hapFile, const char *codePath, BdsExtractStats *stats = nullptr);
+    int32_t ExtractHapArchive(const char *hapFile, const char *codePath, BdsExtractStats *stats = nullptr);
+    int32_t ExtractHapUpdate(const char *hapFile, const char *codePath, const char *installedPath,
+        bool isArchiveMode, BdsExtractStats *stats = nullptr);
+    int32_t ApplyHapPatch(const char *patchFile, const char *baseCodePath, const char *hapFile);
     int32_t RenameFile(const char *oldFile, const char *newFile);
     int32_t CreatePermissionDir();
     int32_t CreateDataDirectory(const char *dataPath, int32_t uid, int32_t gid, bool isChown);
     int32_t StoreContentToFile(const char *file, const void *buffer, uint32_t size);
+    int32_t AppendContentToFile(const char *file, const void *buffer, uint32_t size, bool isSync);
     int32_t MoveFile(const char *oldFile, const char *newFile);
     int32_t RemoveFile(const char *file);
     int32_t RemoveInstallDirectory(const char *codePath, const char *dataPath, bool keepData);
-    int32_t CallClientInvoke(int32_t funcId, const char *firstPath, const char *secondPath);
+    int32_t CallClientInvoke(int32_t funcId, const char *firstPath, const char *secondPath,
+        BdsExtractStats *stats = nullptr);
     static int32_t BundleDaemonCallback(uint32_t code, IpcIo* data, IpcIo* reply, MessageOption option);
     static void DeathCallback(void* arg);
     static int Notify(IOwner owner, int code, IpcIo *reply);
@@ -58,6 +65,7 @@ private:
     sem_t sem_;
     Mutex mutex_;
     int32_t result_ = EC_FAILURE;
+    BdsExtractStats extractStats_ {};
     bool initialized_ = false;
 
     static void *RegisterDeathCallback(void *);
@@ -16,13 +16,16 @@
 #ifndef OHOS_BUNDLE_EXTRACTOR_H
 #define OHOS_BUNDLE_EXTRACTOR_H
 
-#include <sstream>
+#include <memory>
 #include <string>
 
+#include "stdint.h"
+
 namespace OHOS {
 class BundleExtractor {
 public:
-    static uint8_t ExtractHapProfile(const std::string &hapFile, std::ostringstream &profileStream);
+    // profile is null-terminated and can be handed to the json parser as it is.
+    static uint8_t ExtractHapProfile(const std::string &hapFile, std::unique_ptr<char[]> &profile);
 private:
     BundleExtractor() = default;
     ~BundleExtractor() = default;
@@ -37,6 +37,13 @@ struct SvcIdentityInfo {
     bool keepData;
 };
 
+struct BatchInstallInfo {
+    char **paths;
+    int32_t num;
+    SvcIdentity *svc;
+    int32_t installLocation;
+};
+
 class BundleInnerFeature : private Feature {
 public:
     static BundleInnerFeature *GetInstance()
@@ -58,10 +65,14 @@ private:
     static uint8_t GetSvcIdentityInfo(
     OHOS::SvcIdentityInfo *info, const SvcIdentity *svc, const char *reqPath, IpcIo *req);
     static uint8_t UninstallInnerBundle(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static uint8_t InstallBatchInnerBundle(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static void FreeBatchInstallInfo(BatchInstallInfo *info);
+    static uint8_t DumpInstallState(const uint8_t funcId, IpcIo *req, IpcIo *reply);
 #ifdef OHOS_DEBUG
     static uint8_t SetExternalInstallMode(const uint8_t funcId, IpcIo *req, IpcIo *reply);
     static uint8_t SetInnerDebugMode(const uint8_t funcId, IpcIo *req, IpcIo *reply);
     static uint8_t SetInnerSignMode(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static uint8_t SetArchiveInstallMode(const uint8_t funcId, IpcIo *req, IpcIo *reply);
 #endif
 
     Identity identity_;
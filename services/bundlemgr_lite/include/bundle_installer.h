@@ -20,6 +20,7 @@
 #include "bundle_info.h"
 #include "bundle_info_utils.h"
 #include "install_param.h"
+#include "install_trace.h"
 #include "hap_sign_verify.h"
 #include "stdint.h"
 
@@ -27,16 +28,32 @@
 #include <vector>
 
 namespace OHOS {
+// a bundle of a batch that is installed and waits for the shared commit of the install records
+struct BatchInstallItem {
+    InstallRecord record;
+    uint8_t hapType;
+    uint32_t index;
+};
+
+struct BatchInstallContext;
+
 class BundleInstaller {
 public:
     BundleInstaller(const std::string &codeDirPath, const std::string &dataDirPath);
     ~BundleInstaller();
 
     uint8_t Install(const char *path, const InstallParam &installParam);
+    // installs the paths whose results are ERR_OK and fills in their results, the others are skipped. the paths
+    // must belong to different bundles, they are installed side by side.
+    void InstallBatch(const char * const paths[], uint8_t results[], uint32_t num, const InstallParam &installParam);
     uint8_t Uninstall(const char *bundleName, const InstallParam &installParam);
-    std::string GetCodeDirPath() const;
-    std::string GetDataDirPath() const;
 private:
+    uint8_t InstallHap(const char *path, const InstallParam &installParam);
+    static void InstallBatchTask(void *context, uint32_t index);
+    void CommitBatch(const std::vector<BatchInstallItem> &items, uint8_t results[]);
+    void RollbackBatch(const std::vector<BatchInstallItem> &items, uint32_t offset, uint32_t num,
+        uint8_t results[]);
+    uint8_t RebuildHapFromPatch(const char *patchPath, const char *randStr, std::string &hapPath);
     uint8_t ProcessBundleInstall(const std::string &path, const char *randStr, InstallRecord &installRecord,
         uint8_t hapType);
     uint8_t HandleFileAndBackUpRecord(const char *codePath, const char *randStr, InstallRecord &record,
@@ -50,14 +67,8 @@ private:
         PermissionTrans *permissionsTrans, int32_t permTransNum);
     bool MatchBundleName(const char *bundleName, const char *matchedBundleName);
     uint8_t CheckInstallFileIsValid(const char *path);
-    void RecordThirdSystemBundle(const char *bundleName, const char *path);
     uint8_t StorePermissions(const char *bundleName, PermissionTrans *permissions, int32_t permNum, bool isUpdate);
     uint8_t CheckVersionAndSignature(const char *bundleName, BundleInfo *bundleInfo);
-    bool RenameJsonFile(const char *fileName, const char *randStr);
-    bool CheckIsThirdSystemBundle(const char *bundleName);
-    bool BackUpInstallRecord(const InstallRecord &record, const char *jsonPath);
-    void InitThirdSystemBundleRecord(const char *bundleName, const char *path);
-    bool BackUpUidAndGidInfo(const InstallRecord &record, const char *jsonPath);
     void ModifyInstallDirByHapType(const InstallParam &installParam, uint8_t hapType);
     uint8_t GetHapType(const char *path);
     void RestoreInstallEnv(const InstallParam &installParam);
@@ -66,6 +77,8 @@ private:
 
     std::string codeDirPath_;
     std::string dataDirPath_;
+    std::vector<BatchInstallItem> *batchItems_ = nullptr;
+    InstallTrace trace_;
 };
 
 #define CHECK_PRO_RESULT(errcode, bundleInfo, permissions, abilityRes)       \
@@ -98,13 +111,12 @@ private:
         }                                                                                \
     } while (0)
 
-#define CHECK_PRO_ROLLBACK(errcode, permissions, bundleInfo, abilityRes, randStr)        \
+#define CHECK_PRO_ROLLBACK(errcode, permissions, bundleInfo, abilityRes)                 \
     do {                                                                                 \
         if ((errcode) != ERR_OK && (bundleInfo) != nullptr) {                                \
             AdapterFree((permissions).permissionTrans);                                    \
             AdapterFree(abilityRes);                                                     \
             ManagerService::GetInstance().RemoveBundleInfo((bundleInfo)->bundleName);      \
-            BundleUtil::DeleteJsonFile((bundleInfo)->bundleName, randStr);                 \
             CLEAR_INSTALL_ENV(bundleInfo);                                               \
             return errcode;                                                              \
         }                                                                                \
@@ -17,6 +17,8 @@
 #define OHOS_BUNDLE_MANAGER_SERVICE_H
 
 #include <map>
+#include <pthread.h>
+#include <string>
 #include <vector>
 
 #include "ability_service_interface.h"
@@ -24,12 +26,18 @@
 #include "bundle_installer.h"
 #include "bundle_info.h"
 #include "bundle_map.h"
+#include "bundle_work_queue.h"
 #include "cJSON.h"
 #include "message.h"
 #include "nocopyable.h"
 #include "stdint.h"
 
 namespace OHOS {
+struct BatchInstallInfo;
+struct BatchInstallWork;
+struct BootScanItem;
+struct SvcIdentityInfo;
+
 class ManagerService {
 public:
     static ManagerService &GetInstance()
@@ -44,19 +52,21 @@ public:
     bool UpdateBundleInfo(BundleInfo *info);
     uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo& bundleInfo);
     uint8_t GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len);
+    uint8_t GetKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len);
     uint32_t GetBundleSize(const char *bundleName);
     std::vector<SvcIdentity> GetServiceId() const;
     int32_t GenerateUid(const char *bundleName, int8_t bundleStyle);
     void RecycleUid(const char *bundleName);
     static bool GetAmsInterface(AmsInnerInterface **amsInterface);
-    std::string GetCodeDirPath() const;
-    std::string GetDataDirPath() const;
     uint8_t SetExternalInstallMode(bool enable);
     bool IsExternalInstallMode() const;
     uint8_t SetDebugMode(bool enable);
     bool IsDebugMode() const;
+    uint8_t SetArchiveInstallMode(bool enable);
+    bool IsArchiveInstallMode() const;
     bool HasSystemCapability(const char *bundleName);
     uint8_t GetSystemAvailableCapabilities(char syscap[][MAX_SYSCAP_NAME_LEN], int32_t *len);
+    bool DumpInstallState(std::string &state);
 #ifdef OHOS_DEBUG
     uint8_t SetSignMode(bool enable);
     bool IsSignMode() const;
@@ -67,14 +77,26 @@ private:
 
     void ScanPackages();
     void ScanSharedLibPath();
-    void ScanAppDir(const char *appDir, const cJSON *uninstallRecord, uint8_t scanFlag);
     void InstallAllSystemBundle(int32_t scanFlag);
     void InstallSystemBundle(const char *fileDir, const char *fileName);
-    void ReloadBundleInfo(const char *codePath, const char *appId, const char *bundleName, bool isSystemApp);
-    void ReloadEntireBundleInfo(const char *appPath, const char *bundleName, int32_t versionCode, uint8_t scanFlag);
-    bool CheckSystemBundleIsValid(const char *appPath, char **bundleName, int32_t &versionCode);
-    bool CheckThirdSystemBundleHasUninstalled(const char *bundleName, const cJSON *object);
+    static void ListBootScanItems(const char *appDir, uint8_t scanFlag, std::vector<BootScanItem> &items);
+    static void CheckBootScanTask(void *context, uint32_t index);
+    static void ParseBootScanTask(void *context, uint32_t index);
+    // reads the hap and the install record of item and decides what to do with it
+    static void CheckBootScanItem(BootScanItem &item);
+    static bool CheckSystemBootScanHap(BootScanItem &item, int32_t &versionCode);
+    static void ParseBootScanProfiles(BootScanItem &item);
+    static bool CreateBootScanStub(BootScanItem &item);
+    static BundleInfo *LoadBundleInfo(const BundleInfo &stub);
+    void ApplyBootScanItem(BootScanItem &item);
+    static bool CheckSystemBundleIsValid(const char *appPath, char **bundleName, int32_t &versionCode);
+    static void ProcessBundleWork(BundleWork &work);
+    bool PrepareInstallWork(SvcIdentityInfo *info, BundleWork &work);
+    bool PrepareBatchInstallWork(BatchInstallInfo *info, BundleWork &work);
+    void InitializeBundles();
     void InstallThirdBundle(const char *path, const SvcIdentity &svc, int32_t installLocation);
+    void InstallThirdBundles(BatchInstallWork &batchWork);
+    void UninstallThirdBundle(const char *bundleName, const SvcIdentity &svc, bool keepData);
     void AddCallbackServiceId(const SvcIdentity &svc);
     void RemoveCallbackServiceId(const SvcIdentity &svc);
     void RestoreUidAndGidMap();
@@ -83,11 +105,21 @@ private:
     std::map<int, std::string> sysUidMap_;
     std::map<int, std::string> sysVendorUidMap_;
     std::map<int, std::string> appUidMap_;
+    // installs of different bundles generate and recycle uids on several workers
+    pthread_mutex_t uidMutex_ = PTHREAD_MUTEX_INITIALIZER;
+    // installs the haps found at boot, a queued work makes its own installer
     BundleInstaller *installer_;
     BundleMap *bundleMap_;
     std::vector<SvcIdentity> svcIdentity_;
+    mutable pthread_mutex_t svcMutex_ = PTHREAD_MUTEX_INITIALIZER;
+    BundleWorkQueue workQueue_;
     bool IsExternalInstallMode_ { false };
     bool isDebugMode_ { false };
+#ifdef APPEXECFWK_ARCHIVE_INSTALL
+    bool isArchiveInstallMode_ { true };
+#else
+    bool isArchiveInstallMode_ { false };
+#endif
 #ifdef OHOS_DEBUG
     bool isSignMode_ { true };
 #endif
@@ -16,6 +16,10 @@
 #ifndef OHOS_BUNDLE_MAP_H
 #define OHOS_BUNDLE_MAP_H
 
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+#include <set>
+#endif
+
 #include "bundle_info.h"
 #include "nocopyable.h"
 #include "stdint.h"
@@ -24,6 +28,15 @@
 namespace OHOS {
 class BundleMap {
 public:
+    // isStub tells a bundle info which is not loaded yet, see AddStub
+    using Visitor = void (*)(const BundleInfo *bundleInfo, bool isStub, void *context);
+    // decides on the fields of a stub only, a bundle info it rejects is not loaded
+    using Filter = bool (*)(const BundleInfo &bundleInfo);
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    // returns the whole bundle info of a stub, it must not call back into the map.
+    using Loader = BundleInfo *(*)(const BundleInfo &stub);
+#endif
+
     static BundleMap *GetInstance()
     {
         static BundleMap instance;
@@ -34,16 +47,33 @@ public:
     void Add(BundleInfo *bundleInfo);
     bool Update(BundleInfo *bundleInfo);
     BundleInfo *Get(const char *bundleName) const;
-    uint8_t GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len) const;
+    uint8_t GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len, Filter filter = nullptr) const;
     uint8_t GetBundleInfosNoReplication(int32_t flags, BundleInfo **bundleInfos, int32_t *len) const;
     uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo) const;
     void Erase(const char *bundleName);
     void EraseAll();
+    // the bundle infos stay locked while visitor runs, it must not call back into the map.
+    void ForEach(Visitor visitor, void *context) const;
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    // a stub has the bundle name, uid, gid, code path, app id, version code and the keep-alive and system app flags
+    // only. It is replaced by what the loader returns the first time the bundle is asked for, or dropped if that
+    // fails.
+    void AddStub(BundleInfo *stub);
+    void SetLoader(Loader loader);
+#endif
 
 private:
     BundleMap();
     void GetCopyBundleInfo(uint32_t flags, const BundleInfo *bundleInfo, BundleInfo &newBundleInfo) const;
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    BundleInfo *LoadStub(Node<BundleInfo *> *node) const;
+    void LoadStubs(Filter filter) const;
+#endif
     List<BundleInfo *> *bundleInfos_;
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    mutable std::set<const BundleInfo *> stubs_;
+    Loader loader_ = nullptr;
+#endif
 
     DISALLOW_COPY_AND_MOVE(BundleMap);
 };
@@ -32,9 +32,12 @@ public:
     ~BundleParser() = default;
 
     BundleInfo *ParseHapProfile(const char *path);
-    uint8_t ParseHapProfile(const std::string &path, Permissions &permissions, BundleRes &bundleRes,
-        BundleInfo **bundleInfo);
+    // a bundle that is not installed yet gets its code and data paths in installDirPath and dataDirPath
+    uint8_t ParseHapProfile(const std::string &path, const std::string &installDirPath, const std::string &dataDirPath,
+        Permissions &permissions, BundleRes &bundleRes, BundleInfo **bundleInfo);
     static int8_t ParseBundleParam(const char *path, char **bundleName, int32_t &versionCode);
+    // reads the keep-alive flag of an installed profile without building its bundle info
+    static bool ParseKeepAlive(const char *path, bool &isKeepAlive);
 private:
     static uint8_t ParseJsonInfo(const cJSON *appObject, const cJSON *configObject, const cJSON *moduleObject,
         BundleProfile &bundleProfile, BundleRes &bundleRes);
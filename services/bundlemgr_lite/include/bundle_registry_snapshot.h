@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_REGISTRY_SNAPSHOT_H
+#define OHOS_BUNDLE_REGISTRY_SNAPSHOT_H
+
+#include <map>
+#include <pthread.h>
+#include <string>
+
+#include "bundle_info.h"
+#include "bundle_map.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// identifies the version of a file which a snapshot entry was taken from
+struct FileStamp {
+    uint64_t ino = 0;
+    uint64_t size = 0;
+    int64_t mtimeSec = 0;
+    int64_t mtimeNsec = 0;
+    int64_t ctimeSec = 0;
+    int64_t ctimeNsec = 0;
+};
+
+// the bundle infos of the registry and the bundle names of the system haps as of the last committed change, so
+// that boot skips unzipping and parsing what did not change since. A bundle info is only used while the serial of
+// its install record is unchanged, a system hap while its file is unchanged. Everything else, and the
+// whole snapshot if it is corrupted or was saved for another locale, is scanned as before.
+class BundleRegistrySnapshot : public NoCopyable {
+public:
+    static BundleRegistrySnapshot &GetInstance()
+    {
+        static BundleRegistrySnapshot instance;
+        return instance;
+    }
+    ~BundleRegistrySnapshot() override;
+
+    static bool GetFileStamp(const std::string &path, FileStamp &stamp);
+    // reads the snapshot with one read, the lookups below are safe from several threads afterwards.
+    bool Load();
+    // drops what Load read once boot is done with it.
+    void Release();
+    // stamp is taken before the hap is checked, so that a hap replaced meanwhile is checked again next time.
+    bool GetHap(const std::string &hapPath, const FileStamp &stamp, std::string &bundleName,
+        int32_t &versionCode) const;
+    // a new bundle info owned by the caller, nullptr if there is none or its install record changed.
+    BundleInfo *GetBundleInfo(const std::string &bundleName) const;
+    // remembers a system hap checked at boot for the next Save.
+    void SetHap(const std::string &hapPath, const FileStamp &stamp, const std::string &bundleName,
+        int32_t versionCode);
+    bool Save(const BundleMap &bundleMap);
+private:
+    struct HapEntry {
+        FileStamp stamp;
+        std::string bundleName;
+        int32_t versionCode = 0;
+    };
+    struct BundleEntry {
+        uint64_t recordSerial = 0;
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    BundleRegistrySnapshot() = default;
+    static bool IsSameStamp(const FileStamp &stamp, const FileStamp &otherStamp);
+    static std::string GetLocale();
+    static void SaveBundleInfo(const BundleInfo *bundleInfo, bool isStub, void *context);
+    bool ParseSnapshot();
+
+    std::string content_;
+    std::map<std::string, HapEntry> haps_;
+    std::map<std::string, BundleEntry> bundles_;
+    // the system haps of this boot, for the next Save
+    std::map<std::string, HapEntry> checkedHaps_;
+    mutable pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
+    // concurrent installs save one after another, the last save sees the last change of the registry
+    pthread_mutex_t saveMutex_ = PTHREAD_MUTEX_INITIALIZER;
+};
+} // namespace OHOS
+#endif // OHOS_BUNDLE_REGISTRY_SNAPSHOT_H
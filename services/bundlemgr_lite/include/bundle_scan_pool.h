@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_SCAN_POOL_H
+#define OHOS_BUNDLE_SCAN_POOL_H
+
+#include <pthread.h>
+
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// runs a task for every index of a batch on a few short-lived threads and the calling thread. The tasks of a
+// batch must not depend on each other, the caller applies their results in index order once Run returns.
+class BundleScanPool : public NoCopyable {
+public:
+    using Task = void (*)(void *context, uint32_t index);
+
+    BundleScanPool(Task task, void *context);
+    ~BundleScanPool() override;
+
+    // returns once task ran for every index in [0, num)
+    void Run(uint32_t num);
+private:
+    static void *WorkerRoutine(void *arg);
+    static uint32_t GetWorkerNum(uint32_t num);
+    void RunTasks();
+
+    Task task_ = nullptr;
+    void *context_ = nullptr;
+    uint32_t num_ = 0;
+    uint32_t next_ = 0;
+    pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
+};
+} // namespace OHOS
+#endif // OHOS_BUNDLE_SCAN_POOL_H
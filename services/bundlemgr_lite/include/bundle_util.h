@@ -52,8 +52,9 @@ public:
     static char *Strscat(char *str[], uint32_t len);
     static void CreateRandStr(char *str, uint32_t len);
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    static cJSON *ConvertUidAndGidToJson(const InstallRecord &installRecord);
-    static bool DeleteUidInfoFromJson(const char *bundleName);
+    // for content larger than one daemon request, it must not contain a '\0'. file is replaced as a whole, by
+    // renaming file + TMP_FILE_SUFFIX over it.
+    static bool StoreContentInChunks(const char *file, const std::string &content);
 #else
     static bool MkDirs(const char *dir);
     static bool RemoveDir(const char *dir);
@@ -66,11 +67,7 @@ private:
     BundleUtil() = default;
     ~BundleUtil() = default;
 
-#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    static cJSON *ObtainUidAndGidJson(bool flag);
-    static bool AddUidAndGidInfo(const InstallRecord &installRecord, cJSON *size, cJSON *uids);
-    static bool DeleteInnerUidInfoFromUidArray(const char *bundleName, cJSON *size, cJSON *uids);
-#else
+#ifndef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
     static char *GetRootDir(const char *dir, int32_t index);
     static bool CheckDirIsEmpty(const char *dir, List<char *>* list);
 #endif
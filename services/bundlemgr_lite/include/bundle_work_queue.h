@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_WORK_QUEUE_H
+#define OHOS_BUNDLE_WORK_QUEUE_H
+
+#include <deque>
+#include <pthread.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+enum BundleWorkPriority : uint8_t {
+    WORK_PRIORITY_INTERACTIVE = 0,
+    WORK_PRIORITY_NORMAL,
+    WORK_PRIORITY_BACKGROUND,
+    WORK_PRIORITY_NUM,
+};
+
+struct BundleWork {
+    uint32_t msgId = 0;
+    BundleWorkPriority priority = WORK_PRIORITY_NORMAL;
+    // works sharing a name run one at a time and in the order they were pushed, an install is pushed under the
+    // path of its hap and takes the name of its bundle with AcquireBundles once it runs
+    std::vector<std::string> bundleNames;
+    // an exclusive work runs alone, after every work pushed before it
+    bool exclusive = false;
+    void *data = nullptr;
+    uint64_t seq = 0;
+};
+
+struct BundleWorkQueueState {
+    uint32_t pending[WORK_PRIORITY_NUM] = { 0 };
+    uint32_t running = 0;
+    uint32_t concurrency = 0;
+};
+
+// runs bundle works on its own threads, the highest priority work whose bundles are free first.
+class BundleWorkQueue : public NoCopyable {
+public:
+    using WorkHandler = void (*)(BundleWork &work);
+
+    BundleWorkQueue(uint32_t concurrency, WorkHandler handler);
+    ~BundleWorkQueue() override = default;
+
+    // the worker threads are started with the first work.
+    bool Push(BundleWork &&work);
+    void GetState(BundleWorkQueueState &state);
+    // waits until no running work holds any of bundleNames and holds them until ReleaseBundles.
+    void AcquireBundles(const std::vector<std::string> &bundleNames);
+    void ReleaseBundles(const std::vector<std::string> &bundleNames);
+private:
+    static void *WorkerRoutine(void *arg);
+    bool StartWorkers();
+    bool IsRunnable(const BundleWork &work) const;
+    bool TakeRunnable(BundleWork &work);
+    void Finish(const BundleWork &work);
+
+    std::deque<BundleWork> works_[WORK_PRIORITY_NUM];
+    std::set<std::string> runningBundles_;
+    pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond_ = PTHREAD_COND_INITIALIZER;
+    WorkHandler handler_ = nullptr;
+    uint32_t concurrency_ = 1;
+    uint32_t workerNum_ = 0;
+    uint32_t running_ = 0;
+    bool exclusiveRunning_ = false;
+    uint64_t nextSeq_ = 0;
+};
+} // namespace OHOS
+#endif // OHOS_BUNDLE_WORK_QUEUE_H
@@ -23,17 +23,29 @@
 #include <vector>
 
 namespace OHOS {
+enum ExtractSyncMode : uint8_t {
+    SYNC_EACH_FILE = 0, // fsync every extracted file before ExtractFileToPath returns
+    SYNC_BY_CALLER,     // caller flushes the whole target directory once, before committing it
+};
+
 class ExtractorUtil {
 public:
     explicit ExtractorUtil(const std::string &filePath);
     ~ExtractorUtil();
     bool Init();
     bool ExtractFileByName(const std::string &fileName, std::ostream &dest) const;
-    const std::vector<std::string> &GetZipFileNames() const;
+    const std::vector<ZipEntryName> &GetZipFileNames() const;
+    bool GetEntry(const std::string &fileName, ZipEntry &zipEntry) const;
     bool ExtractFileToPath(const std::string &filePath, const std::string &fileName) const;
+    // fd must be opened for read and write, it is truncated before the entry is written.
+    bool ExtractFileToFd(int32_t fd, const std::string &fileName) const;
+    void SetSyncMode(ExtractSyncMode syncMode);
+    // must be called before Init.
+    void SetReadHint(FileReadHint hint, bool dropCacheOnClose);
 private:
     ZipFile zipFile_;
     bool initial_ { false };
+    ExtractSyncMode syncMode_ { SYNC_EACH_FILE };
 };
 } // namespace OHOS
 #endif // OHOS_BUNDLE_EXTRACTOR_UTIL_H
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILE_READ_HINT_H
+#define OHOS_FILE_READ_HINT_H
+
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include "stdint.h"
+
+// define APPEXECFWK_FILE_READ_HINT to 0 to build without any access pattern hints
+#ifndef APPEXECFWK_FILE_READ_HINT
+#define APPEXECFWK_FILE_READ_HINT 1
+#endif
+
+namespace OHOS {
+enum FileReadHint : uint8_t {
+    FILE_READ_HINT_NONE = 0,
+    FILE_READ_HINT_SEQUENTIAL, // larger readahead for a front to back read
+    FILE_READ_HINT_WILLNEED,   // start reading the whole range into the page cache now
+};
+
+// advises how [offset, offset + length) of fd is going to be read, length 0 means up to the end of the file.
+// hints are best effort, a kernel or libc without posix_fadvise simply ignores them.
+inline void AdviseFileRead(int32_t fd, off_t offset, off_t length, FileReadHint hint)
+{
+#if APPEXECFWK_FILE_READ_HINT && defined(POSIX_FADV_SEQUENTIAL)
+    if (fd < 0 || hint == FILE_READ_HINT_NONE) {
+        return;
+    }
+    int32_t advice = (hint == FILE_READ_HINT_WILLNEED) ? POSIX_FADV_WILLNEED : POSIX_FADV_SEQUENTIAL;
+    (void) posix_fadvise(fd, offset, length, advice);
+#else
+    (void) fd;
+    (void) offset;
+    (void) length;
+    (void) hint;
+#endif
+}
+
+// drops the clean pages of fd that nobody is going to read again, e.g. a hap after it has been extracted.
+inline void AdviseFileDrop(int32_t fd, off_t offset, off_t length)
+{
+#if APPEXECFWK_FILE_READ_HINT && defined(POSIX_FADV_DONTNEED)
+    if (fd >= 0) {
+        (void) posix_fadvise(fd, offset, length, POSIX_FADV_DONTNEED);
+    }
+#else
+    (void) fd;
+    (void) offset;
+    (void) length;
+#endif
+}
+} // namespace OHOS
+#endif // OHOS_FILE_READ_HINT_H
@@ -17,12 +17,13 @@
 #define OHOS_GT_BUNDLE_EXTRACTOR_H
 
 #include "bundle_common.h"
+#include "install_trace.h"
 
 namespace OHOS {
 class GtBundleExtractor {
 public:
     static uint8_t ExtractHap(const char *codePath, const char *bundleName, int32_t fp, uint32_t totalFileSize,
-        uint8_t bundleStyle);
+        uint8_t bundleStyle, InstallTrace *trace = nullptr);
     static char *ExtractHapProfile(int32_t fp, uint32_t totalFileSize);
     static uint8_t ExtractBundleParam(const char *path, int32_t &fpStart, char **bundleName);
     static uint8_t ExtractInstallMsg(const char *path, char **bundleName, char **label, char **smallIconPath,
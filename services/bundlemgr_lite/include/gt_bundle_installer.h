@@ -28,6 +28,7 @@ extern "C" {
 #include "bundle_info_utils.h"
 #include "bundle_manager.h"
 #include "bundle_manager_inner.h"
+#include "install_trace.h"
 #include "stdint.h"
 
 namespace OHOS {
@@ -39,6 +40,7 @@ public:
     uint8_t Install(const char *path, InstallerCallback installerCallback);
     uint8_t Uninstall(const char *bundleName);
 private:
+    uint8_t InstallHap(const char *path, InstallerCallback installerCallback);
     uint8_t PreCheckBundle(const char *path, int32_t &fp, SignatureInfo &signatureInfo, uint32_t &fileSize,
         uint8_t bundleStyle);
     uint8_t ProcessBundleInstall(const char *path, const char *randStr, InstallRecord &installRecord,
@@ -65,6 +67,8 @@ private:
     uint8_t AddBundleResList(const char *bundleName, uint32_t labelId, uint32_t iconId);
     uint8_t MoveRawFileToDataPath(const BundleInfo *bundleInfo);
     uint8_t TransformJsToBc(const char *codePath, InstallRecord &record);
+
+    InstallTrace trace_;
 };
 
 #define FREE_PRO_RESOURCE(fp, permissions, bundleInfo) \
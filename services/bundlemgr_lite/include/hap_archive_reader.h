@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_HAP_ARCHIVE_READER_H
+#define OHOS_HAP_ARCHIVE_READER_H
+
+#include <ostream>
+#include <string>
+
+#include "nocopyable.h"
+#include "stdint.h"
+#include "zip_file.h"
+
+namespace OHOS {
+// gives the runtime access to the files of a module installed in archive mode. Only the profile, resource index
+// and shared libs are extracted by such an install, everything else is read straight out of the kept hap.
+class HapArchiveReader : public NoCopyable {
+public:
+    // moduleCodePath is the code path of the module, e.g. /storage/app/run/<bundleName>/<moduleName>
+    explicit HapArchiveReader(const std::string &moduleCodePath);
+    ~HapArchiveReader() override = default;
+
+    static bool IsArchiveModule(const std::string &moduleCodePath);
+    bool Init();
+    // entryName is relative to the module code path, e.g. assets/js/default/app.js
+    bool HasEntry(const std::string &entryName) const;
+    bool GetEntrySize(const std::string &entryName, uint32_t &size) const;
+    bool ReadEntry(const std::string &entryName, std::ostream &dest) const;
+    // filePath is a path under the module code path, such as an icon path of BundleInfo
+    bool GetEntryName(const std::string &filePath, std::string &entryName) const;
+private:
+    std::string moduleCodePath_;
+    ZipFile zipFile_;
+    bool initial_ { false };
+};
+} // namespace OHOS
+#endif // OHOS_HAP_ARCHIVE_READER_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_HAP_PATCH_H
+#define OHOS_HAP_PATCH_H
+
+#include <string>
+
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// Patch file: descript a signed hap as a diff against the installed version of its bundle, little endian
+//    magic "HAPPATCH"                8 bytes
+//    format version                  4 bytes
+//    versionCode of the base         4 bytes
+//    size of the target hap          4 bytes
+//    crc-32 of the target hap        4 bytes
+//    bundle name length              2 bytes
+//    bundle name (variable size)
+// followed by ops up to the end of the file, each starts with a 1 byte op type
+//    PATCH_OP_INSERT: length (4 bytes) followed by as many bytes of the target hap
+//    PATCH_OP_COPY:   file name length (2 bytes), file name, offset (4 bytes) and length (4 bytes) of a range copied
+//                     from a file of the installed module code path, such as its kept archive.hap or a stored entry
+struct __attribute__((packed)) HapPatchFileHeader {
+    char magic[8] = { 0 };
+    uint32_t version = 0;
+    int32_t baseVersionCode = 0;
+    uint32_t targetSize = 0;
+    uint32_t targetCrc = 0;
+    uint16_t bundleNameLength = 0;
+};
+
+enum HapPatchOp : uint8_t {
+    PATCH_OP_INSERT = 0,
+    PATCH_OP_COPY = 1,
+};
+
+struct HapPatchHeader {
+    int32_t baseVersionCode = 0;
+    uint32_t targetSize = 0;
+    uint32_t targetCrc = 0;
+    std::string bundleName;
+};
+
+// rebuilds the hap described by a patch file. The result only has to match the crc-32 of the header here, it is
+// installed like any other hap afterwards and so goes through the signature verification of its own digest.
+class HapPatch : public NoCopyable {
+public:
+    explicit HapPatch(const std::string &patchPath);
+    ~HapPatch() override;
+
+    // reads and checks the header.
+    bool Open();
+    const HapPatchHeader &GetHeader() const;
+    // writes the target hap to targetPath, which must not exist. baseDir is the code path of the installed module,
+    // e.g. /storage/app/run/<bundleName>/<moduleName>/. Nothing is left at targetPath on failure.
+    bool Apply(const std::string &baseDir, const std::string &targetPath);
+private:
+    struct PatchSource {
+        std::string name;
+        int32_t fd = -1;
+        uint64_t size = 0;
+    };
+
+    bool ReadPatch(void *buffer, uint32_t length);
+    bool WriteTarget(const std::string &baseDir, int32_t targetFd);
+    bool OpenSource(const std::string &baseDir, const std::string &name, PatchSource &source) const;
+    bool CopyRange(int32_t srcFd, uint64_t offset, uint32_t length, int32_t targetFd, unsigned long &crc);
+
+    std::string patchPath_;
+    HapPatchHeader header_;
+    int32_t fd_ = -1;
+    uint64_t patchSize_ = 0;
+    uint64_t readPos_ = 0;
+};
+} // namespace OHOS
+#endif // OHOS_HAP_PATCH_H
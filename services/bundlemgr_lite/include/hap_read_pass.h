@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_HAP_READ_PASS_H
+#define OHOS_HAP_READ_PASS_H
+
+#include <string>
+
+#include "hap_verify_cache.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// has the kernel read a hap into the page cache in the background before it is parsed, verified and extracted.
+// The profile parser, APPVERI_AppVerify and the extractor of bundle_daemon open the hap on their own, they find
+// its pages cached or on the way. Only the head and the tail of the hap are read here, for its HapVerifyCache key.
+class HapReadPass : public NoCopyable {
+public:
+    explicit HapReadPass(const std::string &hapPath);
+    ~HapReadPass() override = default;
+
+    // false if the hap is not read ahead, e.g. it is too large to stay cached until it is extracted. Its
+    // readers then go to flash on their own, as they did without the pass.
+    bool Run();
+    // the size of the hap read ahead
+    uint32_t GetBytesRead() const;
+    // only valid after Run succeeded
+    const HapFileKey &GetFileKey() const;
+private:
+    std::string hapPath_;
+    HapFileKey fileKey_;
+    uint32_t bytesRead_ = 0;
+};
+} // namespace OHOS
+#endif // OHOS_HAP_READ_PASS_H
@@ -31,6 +31,8 @@ extern "C" {
 #include <vector>
 
 namespace OHOS {
+struct HapFileKey;
+
 struct SignatureInfo {
     std::string appId;
     std::string provisionBundleName;
@@ -39,7 +41,9 @@ struct SignatureInfo {
 
 class HapSignVerify {
 public:
-    static uint8_t VerifySignature(const std::string &hapFilepath, SignatureInfo &signatureInfo);
+    // fileKey is the key of a hap which HapReadPass has just read ahead
+    static uint8_t VerifySignature(const std::string &hapFilepath, SignatureInfo &signatureInfo,
+        const HapFileKey *fileKey = nullptr);
 private:
     HapSignVerify() = default;
     ~HapSignVerify() = default;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_HAP_VERIFY_CACHE_H
+#define OHOS_HAP_VERIFY_CACHE_H
+
+#include <pthread.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "hap_sign_verify.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// identifies a hap file and its content without digesting all of it. Any write to the file changes its ctime,
+// which cannot be set back, so a rewritten hap never matches the key of the hap it replaced.
+struct HapFileKey {
+    uint64_t dev = 0;
+    uint64_t ino = 0;
+    uint64_t size = 0;
+    int64_t mtimeSec = 0;
+    int64_t mtimeNsec = 0;
+    int64_t ctimeSec = 0;
+    int64_t ctimeNsec = 0;
+    // crc-32 of the head and the tail of the file, where the zip directory and the signing block are
+    uint32_t partialHash = 0;
+};
+
+// keeps the signature infos of verified haps across reboots, so that reinstalling an unchanged hap skips
+// APPVERI_AppVerify. The cache file is only written by bundle_daemon and is dropped as a whole when its checksum
+// or its ownership do not match.
+class HapVerifyCache : public NoCopyable {
+public:
+    static HapVerifyCache &GetInstance()
+    {
+        static HapVerifyCache instance;
+        return instance;
+    }
+    ~HapVerifyCache() override;
+
+    static bool MakeKey(const std::string &hapPath, HapFileKey &key);
+    static bool IsSameKey(const HapFileKey &key, const HapFileKey &otherKey);
+    // an entry of the same file which does not match key or debugMode any more is removed.
+    bool Lookup(const HapFileKey &key, bool debugMode, SignatureInfo &signatureInfo);
+    void Store(const HapFileKey &key, bool debugMode, const SignatureInfo &signatureInfo);
+private:
+    struct Entry {
+        std::string fileId;
+        std::string key;
+        bool debugMode = false;
+        SignatureInfo signatureInfo;
+    };
+
+    HapVerifyCache() = default;
+    static void SetKeyStat(const struct stat &fileStat, HapFileKey &key);
+    // the partial hash covers [0, headLength) and then [tailOffset, size)
+    static void GetPartialHashRanges(uint64_t size, uint64_t &headLength, uint64_t &tailOffset);
+    static std::string GetFileId(const HapFileKey &key);
+    static std::string KeyToString(const HapFileKey &key);
+    static bool ReadCacheFile(std::string &content);
+    void Load();
+    // drops the oldest entries which do not fit in the cache file
+    bool Save();
+
+    std::vector<Entry> entries_;
+    bool loaded_ = false;
+    pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
+};
+} // namespace OHOS
+#endif // OHOS_HAP_VERIFY_CACHE_H
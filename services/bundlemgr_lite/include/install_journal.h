@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_INSTALL_JOURNAL_H
+#define OHOS_INSTALL_JOURNAL_H
+
+#include <deque>
+#include <pthread.h>
+#include <set>
+#include <string>
+
+#include "bundle_common.h"
+#include "cJSON.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// an append-only log of the changes to the install records, their uids and the third system bundle lists.
+// Committing a transaction costs one durable append, and the transactions committed at the same time share that
+// append. The InstallRecordStore catches up in a checkpoint, which replays every committed transaction as one
+// batch and then drops the journal. A transaction torn by a power loss was never committed and is left out.
+class InstallJournal : public NoCopyable {
+public:
+    static InstallJournal &GetInstance()
+    {
+        static InstallJournal instance;
+        return instance;
+    }
+    ~InstallJournal() override;
+
+    // checkpoints what was committed before the last shutdown, it has to run before the records are read.
+    void Recover();
+    // the records of the installed or updated bundles are committed together or not at all, a third system
+    // bundle is recorded as such in the same transaction.
+    bool CommitInstall(const InstallRecord *records, const uint8_t *hapTypes, uint32_t num);
+    // how many of the records, from the first on, fit into a single CommitInstall
+    static uint32_t GetInstallCommitNum(const InstallRecord *records, const uint8_t *hapTypes, uint32_t num);
+    bool CommitUninstall(const char *bundleName, bool isThirdSystem);
+    // whether a committed install recorded the bundle as a third system bundle, checkpointed or not
+    bool IsThirdSystemBundle(const char *bundleName);
+private:
+    struct Transaction {
+        std::string line;
+        bool done = false;
+        bool result = false;
+    };
+
+    InstallJournal() = default;
+    bool Commit(cJSON *operations);
+    void FlushPending();
+    bool Checkpoint();
+    void CheckpointIfFull();
+
+    std::deque<Transaction *> pending_;
+    bool busy_ = false;
+    uint32_t journalSize_ = 0;
+    // the third system bundles committed since the last checkpoint
+    std::set<std::string> thirdSystemBundles_;
+    pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond_ = PTHREAD_COND_INITIALIZER;
+};
+} // namespace OHOS
+#endif // OHOS_INSTALL_JOURNAL_H
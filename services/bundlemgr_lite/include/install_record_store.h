@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_INSTALL_RECORD_STORE_H
+#define OHOS_INSTALL_RECORD_STORE_H
+
+#include <map>
+#include <pthread.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bundle_common.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+struct StoredRecord {
+    std::string codePath;
+    std::string appId;
+    int32_t versionCode = -1;
+    int32_t uid = INVALID_UID;
+    int32_t gid = INVALID_GID;
+    // changes with every put of the record, see BundleRegistrySnapshot
+    uint64_t serial = 0;
+};
+
+// changes to the install record store which are stored together or not at all
+class InstallRecordBatch {
+public:
+    InstallRecordBatch() = default;
+    ~InstallRecordBatch() = default;
+
+    // the uid of the bundle is put along with its record
+    void PutRecord(const InstallRecord &record);
+    // the uid of the bundle is removed along with its record
+    void RemoveRecord(const std::string &bundleName);
+    // removes the uid only, the record is kept
+    void ReleaseUid(const std::string &bundleName);
+    void AddThirdSystemBundle(const std::string &bundleName);
+    void AddUninstalledThirdSystemBundle(const std::string &bundleName);
+    bool IsEmpty() const
+    {
+        return changes_.empty();
+    }
+private:
+    friend class InstallRecordStore;
+    enum ChangeType {
+        PUT_RECORD,
+        REMOVE_RECORD,
+        RELEASE_UID,
+        ADD_THIRD_SYSTEM_BUNDLE,
+        ADD_UNINSTALLED_THIRD_SYSTEM_BUNDLE,
+    };
+    struct Change {
+        ChangeType type;
+        std::string bundleName;
+        StoredRecord record;
+    };
+
+    std::vector<Change> changes_;
+};
+
+// the install records, the uid map and the lists of third system bundles in one file, which is read once into
+// memory and replaced as a whole by each batch, the store it replaced is kept to fall back to. It takes over the
+// record jsons, uid_gid_map.json, third_system_bundle.json and uninstalled_delbundle.json the first time it is
+// loaded.
+class InstallRecordStore : public NoCopyable {
+public:
+    static InstallRecordStore &GetInstance()
+    {
+        static InstallRecordStore instance;
+        return instance;
+    }
+    ~InstallRecordStore() override;
+
+    // false until the first install record is stored, i.e. on the first boot
+    bool IsCreated();
+    bool GetRecord(const std::string &bundleName, StoredRecord &record);
+    // the record has a code path dir named after the bundle, an appId and a version code, see CheckBundleJsonIsValid
+    bool CheckRecordIsValid(const std::string &bundleName, StoredRecord &record);
+    void GetUids(std::map<std::string, int32_t> &uids);
+    bool IsThirdSystemBundle(const std::string &bundleName);
+    bool IsUninstalledThirdSystemBundle(const std::string &bundleName);
+    bool Apply(const InstallRecordBatch &batch);
+private:
+    struct UidEntry {
+        int32_t uid = INVALID_UID;
+        int32_t gid = INVALID_GID;
+    };
+    struct Tables {
+        std::map<std::string, StoredRecord> records;
+        std::map<std::string, UidEntry> uids;
+        std::set<std::string> thirdSystemBundles;
+        std::set<std::string> uninstalledThirdSystemBundles;
+        uint64_t nextSerial = 1;
+    };
+
+    InstallRecordStore() = default;
+    static bool ReadStoreFile(const char *path, Tables &tables);
+    static bool ParseTables(const std::string &content, size_t offset, Tables &tables);
+    static std::string SerializeTables(const Tables &tables);
+    static void MigrateRecordJsons(Tables &tables);
+    static void MigrateUidMap(Tables &tables);
+    static void MigrateBundleList(const char *path, std::set<std::string> &bundleNames);
+    static void RemoveJsonFiles();
+    void LoadIfNeeded();
+
+    Tables tables_;
+    bool loaded_ = false;
+    bool created_ = false;
+    pthread_mutex_t mutex_ = PTHREAD_MUTEX_INITIALIZER;
+};
+} // namespace OHOS
+#endif // OHOS_INSTALL_RECORD_STORE_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_INSTALL_TRACE_H
+#define OHOS_INSTALL_TRACE_H
+
+#include "bundle_common.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+enum InstallPhase : uint8_t {
+    INSTALL_PHASE_PREPARE = 0, // path checks and patch rebuild
+    INSTALL_PHASE_PARSE,       // profile parsing
+    INSTALL_PHASE_VERIFY,      // signature, provision and version checks
+    INSTALL_PHASE_EXTRACT,
+    INSTALL_PHASE_TRANSFORM,   // resources to bundle info, js to bc
+    INSTALL_PHASE_PERMISSION,
+    INSTALL_PHASE_RECORD,      // code path rename, record jsons, uid map and bundle map
+    INSTALL_PHASE_NUM,
+};
+
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+const uint8_t MAX_INSTALL_REPORT_NUM = 16;
+#else
+const uint8_t MAX_INSTALL_REPORT_NUM = 4;
+#endif
+
+struct InstallReport {
+    char bundleName[MAX_BUNDLE_NAME_LEN + 1];
+    uint8_t result;
+    // in microseconds. Extraction may run while the signature is verified, so the phases can add up to more
+    // than the total
+    uint32_t phaseCost[INSTALL_PHASE_NUM];
+    uint32_t totalCost;
+    uint32_t bytesRead;
+    uint32_t bytesWritten;
+    uint32_t fileCount;
+};
+
+// times the phases of one install, entering a phase ends the previous one and a phase may be entered again.
+class InstallTrace : public NoCopyable {
+public:
+    InstallTrace() = default;
+    ~InstallTrace() override = default;
+
+    // starts a new report in INSTALL_PHASE_PREPARE.
+    void Start();
+    void BeginPhase(InstallPhase phase);
+    void EndPhase();
+    // for work timed on another thread.
+    void AddPhaseCost(InstallPhase phase, uint32_t cost);
+    void AddIo(uint32_t bytesRead, uint32_t bytesWritten, uint32_t fileCount);
+    void SetBundleName(const char *bundleName);
+    // ends the current phase and keeps the report in InstallReportRecorder.
+    void Finish(uint8_t result);
+
+    static const char *GetPhaseName(InstallPhase phase);
+    // monotonic, in microseconds
+    static uint64_t GetCurrentTime();
+private:
+    InstallReport report_ {};
+    uint64_t startTime_ = 0;
+    uint64_t phaseStartTime_ = 0;
+    InstallPhase phase_ = INSTALL_PHASE_NUM;
+};
+
+// keeps the last MAX_INSTALL_REPORT_NUM install reports.
+class InstallReportRecorder {
+public:
+    static InstallReportRecorder &GetInstance()
+    {
+        static InstallReportRecorder instance;
+        return instance;
+    }
+    ~InstallReportRecorder();
+
+    void Add(const InstallReport &report);
+    // copies up to num reports, the latest first, and returns how many were copied.
+    uint32_t GetReports(InstallReport reports[], uint32_t num) const;
+private:
+    InstallReportRecorder();
+
+    InstallReport reports_[MAX_INSTALL_REPORT_NUM] {};
+    uint32_t next_ = 0;
+    uint32_t count_ = 0;
+
+    DISALLOW_COPY_AND_MOVE(InstallReportRecorder);
+};
+} // namespace OHOS
+#endif // OHOS_INSTALL_TRACE_H
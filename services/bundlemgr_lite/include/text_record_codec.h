@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_TEXT_RECORD_CODEC_H
+#define OHOS_TEXT_RECORD_CODEC_H
+
+#include <string>
+#include <sys/types.h>
+
+#include "stdint.h"
+
+namespace OHOS {
+// bundle_daemon stores c strings only, so the files kept through it hold no '\0': an integer is written in decimal
+// and ended by a space, a string is prefixed with its length and a colon, and a null string is a single '-'.
+class TextRecordWriter {
+public:
+    explicit TextRecordWriter(std::string &out) : out_(out) {}
+    ~TextRecordWriter() = default;
+
+    void PutInt(int64_t value);
+    void PutString(const char *value);
+    void PutString(const std::string &value);
+private:
+    std::string &out_;
+};
+
+class TextRecordReader {
+public:
+    TextRecordReader(const std::string &content, size_t offset, size_t length)
+        : content_(content), pos_(offset), end_(offset + length) {}
+    ~TextRecordReader() = default;
+
+    size_t GetPos() const
+    {
+        return pos_;
+    }
+    bool Skip(size_t length);
+    bool GetInt(int64_t &value);
+    // fails for a value out of the range of T
+    template<typename T>
+    bool GetInt(T &value)
+    {
+        int64_t number = 0;
+        if (!GetInt(number)) {
+            return false;
+        }
+        value = static_cast<T>(number);
+        return static_cast<int64_t>(value) == number;
+    }
+    bool GetBool(bool &value);
+    // fails for a null string
+    bool GetString(std::string &value);
+    // value is allocated with AdapterMalloc, or nullptr for a null string
+    bool GetString(char *&value);
+private:
+    bool GetRawString(const char *&value, size_t &length);
+
+    const std::string &content_;
+    size_t pos_;
+    size_t end_;
+};
+
+// a file of text records starts with a line of its magic, its format version, the crc-32 of the payload and the
+// payload length, the payload follows.
+class TextRecordFile {
+public:
+    static std::string Seal(const char *magic, int64_t version, const std::string &payload);
+    // the payload is content[payloadOffset, content.size()) if content is intact and of this magic and version
+    static bool Unseal(const std::string &content, const char *magic, int64_t version, size_t &payloadOffset);
+    // reads a file only bundle_daemon can have written, see HapVerifyCache
+    static bool Read(const char *path, off_t maxSize, std::string &content);
+    static bool Write(const char *path, const std::string &content);
+private:
+    TextRecordFile() = default;
+    ~TextRecordFile() = default;
+};
+} // namespace OHOS
+#endif // OHOS_TEXT_RECORD_CODEC_H
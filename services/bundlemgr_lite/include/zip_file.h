@@ -16,10 +16,12 @@
 #ifndef OHOS_BUNDLE_ZIP_FILE_H
 #define OHOS_BUNDLE_ZIP_FILE_H
 
-#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "file_read_hint.h"
 #include "stdint.h"
 #include "unzip.h"
 
@@ -30,7 +32,7 @@ using LocalHeader = struct LocalHeader;
 using EndDir = struct EndDir;
 using DataDesc = struct DataDesc;
 using ZipEntry = struct ZipEntry;
-using ZipEntryMap = std::map<std::string, ZipEntry>;
+using ZipEntryName = struct ZipEntryName;
 using BytePtr = Byte *;
 
 // Local file header: descript in APPNOTE-6.3.4
@@ -123,6 +125,25 @@ struct __attribute__((packed)) DataDesc {
     uint32_t uncompressedSize = 0;
 };
 
+// entry name which points into the central directory buffer owned by ZipFile, it is not null-terminated.
+struct ZipEntryName {
+    const char *data = nullptr;
+    size_t length = 0;
+
+    std::string ToString() const
+    {
+        return std::string(data, length);
+    }
+
+    bool operator==(const ZipEntryName &other) const;
+};
+
+struct ZipEntryNameHash {
+    size_t operator()(const ZipEntryName &name) const;
+};
+
+using ZipEntryMap = std::unordered_map<ZipEntryName, ZipEntry, ZipEntryNameHash>;
+
 struct ZipEntry {
     ZipEntry() = default;
     explicit ZipEntry(const CentralDirEntry &centralEntry);
@@ -134,7 +155,7 @@ struct ZipEntry {
     uint32_t localHeaderOffset = 0;
     uint32_t crc = 0;
     uint16_t flags = 0;
-    std::string fileName;
+    ZipEntryName fileName;
 };
 
 // zip file extract class for bundle format.
@@ -144,39 +165,70 @@ public:
     ~ZipFile();
 
     bool Open();
+    // only reads the central directory, entries are looked up by scanning it instead of through an index.
+    // suits callers which need one or two entries, GetAllEntries and GetFileNames stay empty.
+    bool OpenWithoutIndex();
     void Close();
     // set this zip content start offset and length in the zip file form pathName.
     void SetContentLocation(ZipPos start, size_t length);
 
     const ZipEntryMap &GetAllEntries() const;
     bool GetEntry(const std::string &entryName, ZipEntry &resultEntry) const;
+    // entry data is read with positional io, so different entries can be extracted concurrently.
     bool ExtractFile(const std::string &file, std::ostream &dest) const;
-    const std::vector<std::string> &GetFileNames() const;
+    // buffer holds the whole entry followed by a '\0', length does not count the terminator. an entry larger than
+    // 1 MiB is rejected.
+    bool ExtractFileToBuffer(const std::string &file, std::unique_ptr<char[]> &buffer, size_t &length) const;
+    const std::vector<ZipEntryName> &GetFileNames() const;
+    // copy a stored (uncompressed) entry to destFd inside the kernel, false if not stored or not supported.
+    bool CopyStoredFile(const std::string &file, int32_t destFd) const;
+    // deflated entries up to limit bytes are inflated in one call into a single buffer, 0 disables it.
+    void SetWholeInflateLimit(uint32_t limit);
+    // must be called before Open, the hint covers the entry data and the cache is dropped again by Close.
+    void SetReadHint(FileReadHint hint, bool dropCacheOnClose);
 
 private:
     bool CheckEndDir(const EndDir &endDir) const;
     bool ParseEndDirectory();
+    bool OpenFile(bool buildIndex);
+    bool ReadCentralDir();
+    bool ParseCentralEntry(int32_t index, size_t &currentPos, ZipEntry &zipEntry) const;
     bool ParseAllEntries();
+    bool ScanEntry(const ZipEntryName &entryName, ZipEntry &zipEntry) const;
     size_t GetLocalHeaderSize(const uint16_t nameSize = 0, const uint16_t extraSize = 0) const;
     bool CheckDataDesc(const ZipEntry &zipEntry, const LocalHeader &localHeader) const;
     bool CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extraSize) const;
+    bool CheckEntryCrc(const ZipEntry &zipEntry, uLong crc) const;
     bool UnzipWithStore(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const;
     bool UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const;
-    bool SeekToEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize) const;
+    bool UnzipWholeInflated(const ZipEntry &zipEntry, ZipPos readPos, std::ostream &dest) const;
+    // dest must hold uncompressedSize + 1 bytes.
+    bool InflateToBuffer(const ZipEntry &zipEntry, ZipPos readPos, Byte *dest) const;
+    bool GetEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize, ZipPos &startOffset) const;
+    bool ReadAt(void *buffer, size_t length, ZipPos offset) const;
+    bool KernelCopy(int32_t destFd, ZipPos srcOffset, uint32_t length) const;
+    bool CheckFdCrc(const ZipEntry &zipEntry, int32_t destFd) const;
     bool InitZStream(z_stream &zstream) const;
-    bool ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &remainCompressedSize) const;
+    bool ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &remainCompressedSize,
+        ZipPos &readPos) const;
 
 private:
     std::string pathName_;
-    FILE* file_ = nullptr;
+    int32_t fd_ = -1;
     EndDir endDir_;
+    // whole central directory, entry names in entriesMap_ and fileNames_ point into it.
+    std::unique_ptr<char[]> centralDir_;
     ZipEntryMap entriesMap_;
     // offset of central directory relative to zip file.
     ZipPos centralDirPos_ = 0;
     // this zip content length in the zip file.
     ZipPos fileLength_ = 0;
     // entryName vector
-    std::vector<std::string> fileNames_;
+    std::vector<ZipEntryName> fileNames_;
+    uint32_t wholeInflateLimit_;
+    FileReadHint readHint_ = FILE_READ_HINT_SEQUENTIAL;
+    bool dropCacheOnClose_ = false;
+    bool isIndexed_ = false;
     bool isOpen_ = false;
 };
 } // namespace OHOS
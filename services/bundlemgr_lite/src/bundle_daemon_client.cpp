@@ -31,6 +31,17 @@ namespace OHOS {
 namespace {
 constexpr unsigned SLEEP_TIME = 200000;
 }
+
+static void ReadExtractStats(IpcIo *io, BdsExtractStats &stats)
+{
+    // only the extract commands send their stats after the result
+    BdsExtractStats extractStats = {};
+    if (ReadUint32(io, &extractStats.bytesRead) && ReadUint32(io, &extractStats.bytesWritten) &&
+        ReadUint32(io, &extractStats.fileCount)) {
+        stats = extractStats;
+    }
+}
+
 #ifdef __LINUX__
 int BundleDaemonClient::Notify(IOwner owner, int code, IpcIo *reply)
 {
@@ -43,6 +54,7 @@ int BundleDaemonClient::Notify(IOwner owner, int code, IpcIo *reply)
         return EC_INVALID;
     }
     ReadInt32(reply, &(client->result_));
+    ReadExtractStats(reply, client->extractStats_);
     int value;
     sem_getvalue(&client->sem_, &value);
     if (value <= 0) {
@@ -59,6 +71,7 @@ int32_t BundleDaemonClient::BundleDaemonCallback(uint32_t code, IpcIo* data, Ipc
     }
 
     ReadInt32(data, &(client->result_));
+    ReadExtractStats(data, client->extractStats_);
     int value;
     sem_getvalue(&client->sem_, &value);
     if (value <= 0) {
@@ -204,7 +217,8 @@ int32_t BundleDaemonClient::RegisterCallback()
     return WaitResultSync(EC_SUCCESS);
 }
 
-int32_t BundleDaemonClient::CallClientInvoke(int32_t funcId, const char *firstPath, const char *secondPath)
+int32_t BundleDaemonClient::CallClientInvoke(int32_t funcId, const char *firstPath, const char *secondPath,
+    BdsExtractStats *stats)
 {
     IpcIo request;
     char data[MAX_IO_SIZE];
@@ -216,14 +230,19 @@ int32_t BundleDaemonClient::CallClientInvoke(int32_t funcId, const char *firstPa
     WriteUint16(&request, strlen(firstPath));
 
     Lock<Mutex> lock(mutex_);
+    extractStats_ = {};
 #ifdef __LINUX__
-    return WaitResultSync(bdsClient_->Invoke(bdsClient_, funcId, &request, this, Notify));
+    int32_t result = WaitResultSync(bdsClient_->Invoke(bdsClient_, funcId, &request, this, Notify));
 #else
-    return WaitResultSync(bdsClient_->Invoke(bdsClient_, funcId, &request, nullptr, nullptr));
+    int32_t result = WaitResultSync(bdsClient_->Invoke(bdsClient_, funcId, &request, nullptr, nullptr));
 #endif
+    if (stats != nullptr) {
+        *stats = extractStats_;
+    }
+    return result;
 }
 
-int32_t BundleDaemonClient::ExtractHap(const char *hapFile, const char *codePath)
+int32_t BundleDaemonClient::ExtractHap(const char *hapFile, const char *codePath, BdsExtractStats *stats)
 {
     if (!initialized_) {
         return EC_NOINIT;
@@ -233,7 +252,79 @@ int32_t BundleDaemonClient::ExtractHap(const char *hapFile, const char *codePath
         return EC_INVALID;
     }
 
-    return CallClientInvoke(EXTRACT_HAP, hapFile, codePath);
+    return CallClientInvoke(EXTRACT_HAP, hapFile, codePath, stats);
+}
+
+int32_t BundleDaemonClient::ExtractHapArchive(const char *hapFile, const char *codePath, BdsExtractStats *stats)
+{
+    if (!initialized_) {
+        return EC_NOINIT;
+    }
+    if (hapFile == nullptr || codePath == nullptr) {
+        PRINTE("BundleDaemonClient", "invalid params: hapFile or codePath is nullptr");
+        return EC_INVALID;
+    }
+
+    return CallClientInvoke(EXTRACT_HAP_ARCHIVE, hapFile, codePath, stats);
+}
+
+int32_t BundleDaemonClient::ExtractHapUpdate(const char *hapFile, const char *codePath, const char *installedPath,
+    bool isArchiveMode, BdsExtractStats *stats)
+{
+    if (!initialized_) {
+        return EC_NOINIT;
+    }
+    if (hapFile == nullptr || codePath == nullptr || installedPath == nullptr) {
+        PRINTE("BundleDaemonClient", "invalid params: hapFile, codePath or installedPath is nullptr");
+        return EC_INVALID;
+    }
+    IpcIo request;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&request, data, MAX_IO_SIZE, 0);
+    std::string innerStr = hapFile;
+    innerStr += codePath;
+    WriteString(&request, innerStr.c_str());
+    WriteUint16(&request, strlen(hapFile));
+    WriteString(&request, installedPath);
+    WriteBool(&request, isArchiveMode);
+
+    Lock<Mutex> lock(mutex_);
+    extractStats_ = {};
+#ifdef __LINUX__
+    int32_t result = WaitResultSync(bdsClient_->Invoke(bdsClient_, EXTRACT_HAP_UPDATE, &request, this, Notify));
+#else
+    int32_t result = WaitResultSync(bdsClient_->Invoke(bdsClient_, EXTRACT_HAP_UPDATE, &request, nullptr, nullptr));
+#endif
+    if (stats != nullptr) {
+        *stats = extractStats_;
+    }
+    return result;
+}
+
+int32_t BundleDaemonClient::ApplyHapPatch(const char *patchFile, const char *baseCodePath, const char *hapFile)
+{
+    if (!initialized_) {
+        return EC_NOINIT;
+    }
+    if (patchFile == nullptr || baseCodePath == nullptr || hapFile == nullptr) {
+        PRINTE("BundleDaemonClient", "invalid params: patchFile, baseCodePath or hapFile is nullptr");
+        return EC_INVALID;
+    }
+    IpcIo request;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&request, data, MAX_IO_SIZE, 0);
+    std::string innerStr = patchFile;
+    innerStr += hapFile;
+    WriteString(&request, innerStr.c_str());
+    WriteUint16(&request, strlen(patchFile));
+    WriteString(&request, baseCodePath);
+
+    Lock<Mutex> lock(mutex_);
+#ifdef __LINUX__
+    return WaitResultSync(bdsClient_->Invoke(bdsClient_, APPLY_HAP_PATCH, &request, this, Notify));
+#else
+    return WaitResultSync(bdsClient_->Invoke(bdsClient_, APPLY_HAP_PATCH, &request, nullptr, nullptr));
+#endif
 }
 
 int32_t BundleDaemonClient::RenameFile(const char *oldFile, const char *newFile)
@@ -311,6 +402,31 @@ int32_t BundleDaemonClient::StoreContentToFile(const char *file, const void *buf
 #endif
 }
 
+int32_t BundleDaemonClient::AppendContentToFile(const char *file, const void *buffer, uint32_t size, bool isSync)
+{
+    if (!initialized_) {
+        return EC_NOINIT;
+    }
+    if (file == nullptr || buffer == nullptr || size == 0) {
+        PRINTE("BundleDaemonClient", "invalid params");
+        return EC_INVALID;
+    }
+    IpcIo request;
+    char data[MAX_IO_SIZE];
+
+    IpcIoInit(&request, data, MAX_IO_SIZE, 0);
+
+    WriteString(&request, file);
+    WriteString(&request, static_cast<const char *>(buffer));
+    WriteBool(&request, isSync);
+    Lock<Mutex> lock(mutex_);
+#ifdef __LINUX__
+    return WaitResultSync(bdsClient_->Invoke(bdsClient_, APPEND_CONTENT_TO_FILE, &request, this, Notify));
+#else
+    return WaitResultSync(bdsClient_->Invoke(bdsClient_, APPEND_CONTENT_TO_FILE, &request, nullptr, nullptr));
+#endif
+}
+
 int32_t BundleDaemonClient::MoveFile(const char *oldFile, const char *newFile)
 {
     if (!initialized_) {
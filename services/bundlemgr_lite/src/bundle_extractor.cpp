@@ -20,19 +20,21 @@
 #include "appexecfwk_errors.h"
 #include "bundle_common.h"
 #include "bundle_util.h"
-#include "extractor_util.h"
 #include "log.h"
+#include "zip_file.h"
 
 namespace OHOS {
-uint8_t BundleExtractor::ExtractHapProfile(const std::string &hapFile, std::ostringstream &profileStream)
+uint8_t BundleExtractor::ExtractHapProfile(const std::string &hapFile, std::unique_ptr<char[]> &profile)
 {
-    ExtractorUtil extractorUtil(hapFile);
-    if (!extractorUtil.Init()) {
+    // only config.json is needed, so skip building the index of all entries
+    ZipFile zipFile(hapFile);
+    if (!zipFile.OpenWithoutIndex()) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleExtractor ExtractHapProfile init fail");
         return ERR_APPEXECFWK_INSTALL_FAILED_EXTRACTOR_NOT_INIT;
     }
 
-    if (!extractorUtil.ExtractFileByName(PROFILE_NAME, profileStream)) {
+    size_t profileLength = 0;
+    if (!zipFile.ExtractFileToBuffer(PROFILE_NAME, profile, profileLength)) {
         HILOG_ERROR(HILOG_MODULE_APP, "it can not find json file!");
         return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
     }
@@ -27,7 +27,8 @@
 #include "utils.h"
 
 namespace OHOS {
-uint8_t BundleInfoCreator::SaveBundleInfo(const BundleProfile &bundleProfile, BundleInfo **bundleInfo)
+uint8_t BundleInfoCreator::SaveBundleInfo(const BundleProfile &bundleProfile, const std::string &installDirPath,
+    const std::string &dataDirPath, BundleInfo **bundleInfo)
 {
     *bundleInfo = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo)));
     if (*bundleInfo == nullptr) {
@@ -41,8 +42,9 @@ uint8_t BundleInfoCreator::SaveBundleInfo(const BundleProfile &bundleProfile, Bu
         *bundleInfo = nullptr;
         return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
     }
-    std::string installDirPath;
-    std::string dataDirPath;
+    // an installed bundle keeps its code and data paths
+    std::string bundleInstallDirPath = installDirPath;
+    std::string bundleDataDirPath = dataDirPath;
     BundleInfo *info = ManagerService::GetInstance().QueryBundleInfo(bundleProfile.bundleName);
     if (info != nullptr) {
         size_t index = std::string(info->codePath).find_last_of(PATH_SEPARATOR);
@@ -50,19 +52,16 @@ uint8_t BundleInfoCreator::SaveBundleInfo(const BundleProfile &bundleProfile, Bu
             HILOG_ERROR(HILOG_MODULE_APP, "codePath is invalid!");
             return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
         }
-        installDirPath = std::string(info->codePath).substr(0, index);
+        bundleInstallDirPath = std::string(info->codePath).substr(0, index);
         index = std::string(info->dataPath).find_last_of(PATH_SEPARATOR);
         if (index == std::string::npos) {
             HILOG_ERROR(HILOG_MODULE_APP, "dataPath is invalid!");
             return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
         }
-        dataDirPath = std::string(info->dataPath).substr(0, index);
-    } else {
-        installDirPath = ManagerService::GetInstance().GetCodeDirPath();
-        dataDirPath = ManagerService::GetInstance().GetDataDirPath();
+        bundleDataDirPath = std::string(info->dataPath).substr(0, index);
     }
 
-    if (!SetBundleInfo(bundleProfile, installDirPath, dataDirPath, *bundleInfo)) {
+    if (!SetBundleInfo(bundleProfile, bundleInstallDirPath, bundleDataDirPath, *bundleInfo)) {
         BundleInfoUtils::FreeBundleInfo(*bundleInfo);
         *bundleInfo = nullptr;
         return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
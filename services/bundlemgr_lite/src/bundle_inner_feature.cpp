@@ -42,10 +42,13 @@ static BmsInnerImpl g_bmsInnerImpl = {
 BundleInvokeType BundleInnerFeature::BundleMsInvokeFuc[BMS_CMD_END - BMS_INNER_BEGIN] {
     InstallInnerBundle,
     UninstallInnerBundle,
+    InstallBatchInnerBundle,
+    DumpInstallState,
 #ifdef OHOS_DEBUG
     SetExternalInstallMode,
     SetInnerDebugMode,
     SetInnerSignMode,
+    SetArchiveInstallMode,
 #endif
 };
 
@@ -224,6 +227,104 @@ uint8_t BundleInnerFeature::UninstallInnerBundle(const uint8_t funcId, IpcIo *re
     return ERR_OK;
 }
 
+uint8_t BundleInnerFeature::InstallBatchInnerBundle(const uint8_t funcId, IpcIo *req, IpcIo *reply)
+{
+    if ((req == nullptr) || (reply == nullptr)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS InstallBatchInnerBundle, request or reply is null");
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    int32_t num = 0;
+    if (!ReadInt32(req, &num) || num <= 0 || num > MAX_INSTALL_BATCH_NUM) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature deserialize batch num failed");
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    BatchInstallInfo *info = reinterpret_cast<BatchInstallInfo *>(AdapterMalloc(sizeof(BatchInstallInfo)));
+    if (info == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc batch install info failed");
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    info->num = num;
+    info->svc = nullptr;
+    info->paths = reinterpret_cast<char **>(AdapterMalloc(sizeof(char *) * num));
+    if (info->paths == nullptr) {
+        AdapterFree(info);
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc batch paths failed");
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    for (int32_t i = 0; i < num; i++) {
+        info->paths[i] = nullptr;
+    }
+    for (int32_t i = 0; i < num; i++) {
+        size_t length = 0;
+        char *reqPath = reinterpret_cast<char *>(ReadString(req, &length));
+        if (reqPath == nullptr) {
+            FreeBatchInstallInfo(info);
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature deserialize batch path failed");
+            return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+        }
+        info->paths[i] = Utils::Strdup(reqPath);
+        if (info->paths[i] == nullptr) {
+            FreeBatchInstallInfo(info);
+            return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+        }
+    }
+    SvcIdentity svc;
+    if (!(ReadRemoteObject(req, &svc))) {
+        FreeBatchInstallInfo(info);
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature deserialize serviceId failed");
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    info->svc = reinterpret_cast<SvcIdentity *>(AdapterMalloc(sizeof(SvcIdentity)));
+    if (info->svc == nullptr) {
+        FreeBatchInstallInfo(info);
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc serviceId failed");
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    *(info->svc) = svc;
+    ReadInt32(req, &(info->installLocation));
+    Request request = {
+        .msgId = BUNDLE_BATCH_INSTALLED,
+        .len = static_cast<int16>(sizeof(BatchInstallInfo)),
+        .data = reinterpret_cast<void *>(info),
+        .msgValue = 0
+    };
+    int32 propRet = SAMGR_SendRequest(&(GetInstance()->identity_), &request, nullptr);
+    if (propRet != OHOS_SUCCESS) {
+        FreeBatchInstallInfo(info);
+        return ERR_APPEXECFWK_INSTALL_FAILED_SEND_REQUEST_ERROR;
+    }
+    return ERR_OK;
+}
+
+void BundleInnerFeature::FreeBatchInstallInfo(BatchInstallInfo *info)
+{
+    if (info == nullptr) {
+        return;
+    }
+    if (info->paths != nullptr) {
+        for (int32_t i = 0; i < info->num; i++) {
+            AdapterFree(info->paths[i]);
+        }
+        AdapterFree(info->paths);
+    }
+    AdapterFree(info->svc);
+    AdapterFree(info);
+}
+
+uint8_t BundleInnerFeature::DumpInstallState(const uint8_t funcId, IpcIo *req, IpcIo *reply)
+{
+    if ((req == nullptr) || (reply == nullptr)) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    std::string state;
+    if (!OHOS::ManagerService::GetInstance().DumpInstallState(state)) {
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+    WriteString(reply, state.c_str());
+    return OHOS_SUCCESS;
+}
+
 #ifdef OHOS_DEBUG
 uint8_t BundleInnerFeature::SetExternalInstallMode(const uint8_t funcId, IpcIo *req, IpcIo *reply)
 {
@@ -266,6 +367,20 @@ uint8_t BundleInnerFeature::SetInnerSignMode(const uint8_t funcId, IpcIo *req, I
     }
     return errorCode;
 }
+
+uint8_t BundleInnerFeature::SetArchiveInstallMode(const uint8_t funcId, IpcIo *req, IpcIo *reply)
+{
+    if ((req == nullptr) || (reply == nullptr)) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    bool mode;
+    ReadBool(req, &mode);
+    uint8_t errorCode = OHOS::ManagerService::GetInstance().SetArchiveInstallMode(mode);
+    if (errorCode == OHOS_SUCCESS) {
+        WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+    }
+    return errorCode;
+}
 #endif
 
 int32 BundleInnerFeature::Invoke(IServerProxy *iProxy, int funcId, void *origin, IpcIo *req, IpcIo *reply)
@@ -278,7 +393,7 @@ int32 BundleInnerFeature::Invoke(IServerProxy *iProxy, int funcId, void *origin,
 #ifdef OHOS_DEBUG
     if ((funcId >= BMS_INNER_BEGIN) && (funcId < BMS_CMD_END)) {
 #else
-    if ((funcId >= BMS_INNER_BEGIN) && (funcId <= UNINSTALL)) {
+    if ((funcId >= BMS_INNER_BEGIN) && (funcId <= DUMP_INSTALL_STATE)) {
 #endif
         ret = BundleMsInvokeFuc[funcId - BMS_INNER_BEGIN](funcId, req, reply);
     } else {
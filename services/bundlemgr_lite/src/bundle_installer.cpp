@@ -16,6 +16,8 @@
 #include "bundle_installer.h"
 
 #include <climits>
+#include <fcntl.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -27,7 +29,12 @@
 #include "bundle_manager_service.h"
 #include "bundle_parser.h"
 #include "bundle_res_transform.h"
+#include "bundle_scan_pool.h"
 #include "bundle_util.h"
+#include "file_read_hint.h"
+#include "hap_patch.h"
+#include "hap_read_pass.h"
+#include "install_journal.h"
 #include "log.h"
 #include "utils.h"
 
@@ -39,6 +46,26 @@ const char APPID[] = "appId";
 #endif
 const uint8_t RAND_NUM = 16;
 
+struct HapExtractTask {
+    std::string hapPath;
+    std::string tmpCodePath;
+    std::string codePath;
+    bool isUpdate = false;
+    bool isArchiveMode = false;
+    int32_t result = EC_FAILURE;
+    BdsExtractStats stats {};
+    uint64_t cost = 0;
+};
+
+struct BatchInstallContext {
+    const char * const *paths;
+    uint8_t *results;
+    const InstallParam *installParam;
+    std::string codeDirPath;
+    std::string dataDirPath;
+    std::vector<std::vector<BatchInstallItem>> items;
+};
+
 BundleInstaller::BundleInstaller(const std::string &codeDirPath, const std::string &dataDirPath)
 {
     HILOG_INFO(HILOG_MODULE_APP, "create BundleInstaller instance!");
@@ -53,16 +80,6 @@ BundleInstaller::~BundleInstaller()
     dataDirPath_.clear();
 }
 
-std::string BundleInstaller::GetCodeDirPath() const
-{
-    return codeDirPath_;
-}
-
-std::string BundleInstaller::GetDataDirPath() const
-{
-    return dataDirPath_;
-}
-
 void BundleInstaller::ModifyInstallDirByHapType(const InstallParam &installParam, uint8_t hapType)
 {
     if (hapType != THIRD_APP_FLAG) {
@@ -104,6 +121,14 @@ uint8_t BundleInstaller::GetHapType(const char *path)
 }
 
 uint8_t BundleInstaller::Install(const char *path, const InstallParam &installParam)
+{
+    trace_.Start();
+    uint8_t errorCode = InstallHap(path, installParam);
+    trace_.Finish(errorCode);
+    return errorCode;
+}
+
+uint8_t BundleInstaller::InstallHap(const char *path, const InstallParam &installParam)
 {
     if (path == nullptr || installParam.installLocation < INSTALL_LOCATION_INTERNAL_ONLY ||
         installParam.installLocation > INSTALL_LOCATION_PREFER_EXTERNAL) {
@@ -130,41 +155,190 @@ uint8_t BundleInstaller::Install(const char *path, const InstallParam &installPa
     uint8_t hapType = GetHapType(realPath);
     ModifyInstallDirByHapType(installParam, hapType);
 
+    // a patch is rebuilt into the signed hap it describes, which is then installed like any other hap
+    std::string hapPath = realPath;
+    bool isPatch = BundleUtil::EndWith(realPath, PATCH_FILE_SUFFIX);
+    if (isPatch) {
+        uint8_t errorCode = RebuildHapFromPatch(realPath, randStr, hapPath);
+        if (errorCode != ERR_OK) {
+            return errorCode;
+        }
+    }
+
     InstallRecord installRecord = {
         .bundleName = nullptr, .codePath = nullptr, .appId = nullptr, .versionCode = -1, .uid = INVALID_UID,
         .gid = INVALID_GID
     };
 
-    uint8_t errorCode = ProcessBundleInstall(realPath, randStr, installRecord, hapType);
+    uint8_t errorCode = ProcessBundleInstall(hapPath, randStr, installRecord, hapType);
+    if (isPatch) {
+        BundleDaemonClient::GetInstance().RemoveFile(hapPath.c_str());
+    }
     if (errorCode != ERR_OK) {
         ManagerService::GetInstance().RecycleUid(installRecord.bundleName);
         return errorCode;
     }
 
-    std::string uidTmpJsonPath = std::string(JSON_PATH) + UID_GID_MAP + randStr + JSON_SUFFIX;
-    if (!BackUpUidAndGidInfo(installRecord, uidTmpJsonPath.c_str())) {
-        HILOG_ERROR(HILOG_MODULE_APP, "backup uid and gid info fail!");
-        BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName);
-        CLEAR_INSTALL_ENV(bundleInfo);
-        return ERR_APPEXECFWK_INSTALL_FAILED_UID_AND_GID_BACKUP_ERROR;
+    if (batchItems_ != nullptr) {
+        batchItems_->push_back({ installRecord, hapType, 0 });
+        RestoreInstallEnv(installParam);
+        return ERR_OK;
     }
 
-    if (!RenameJsonFile(UID_GID_MAP, randStr) || !RenameJsonFile(installRecord.bundleName, randStr)) {
-        HILOG_ERROR(HILOG_MODULE_APP, "rename uid_gid_map json or record json fail!");
+    // the bundle is installed once its record is in the install journal
+    if (!InstallJournal::GetInstance().CommitInstall(&installRecord, &hapType, 1)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "commit install record fail!");
         BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName);
         CLEAR_INSTALL_ENV(bundleInfo);
-        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_FILE_ERROR;
+        return ERR_APPEXECFWK_INSTALL_FAILED_RECORD_INFO_ERROR;
     }
 
-    // if third system bundle, it need to record bundleName in THIRD_SYSTEM_BUNDLE_JSON
-    if (hapType == THIRD_SYSTEM_APP_FLAG && !CheckIsThirdSystemBundle(installRecord.bundleName)) {
-        RecordThirdSystemBundle(installRecord.bundleName, THIRD_SYSTEM_BUNDLE_JSON);
+    RestoreInstallEnv(installParam);
+    return ERR_OK;
+}
+
+void BundleInstaller::InstallBatch(const char * const paths[], uint8_t results[], uint32_t num,
+    const InstallParam &installParam)
+{
+    if (paths == nullptr || results == nullptr) {
+        return;
     }
+    // the haps of a batch belong to different bundles, one is verified while another is extracted
+    BatchInstallContext context = { paths, results, &installParam, codeDirPath_, dataDirPath_, {} };
+    context.items.resize(num);
+    BundleScanPool installPool(InstallBatchTask, &context);
+    installPool.Run(num);
+    // only committing the install records is left to CommitBatch, in the order of the batch
+    std::vector<BatchInstallItem> items;
+    for (const auto &hapItems : context.items) {
+        items.insert(items.end(), hapItems.begin(), hapItems.end());
+    }
+    CommitBatch(items, results);
+}
 
-    RestoreInstallEnv(installParam);
+void BundleInstaller::InstallBatchTask(void *context, uint32_t index)
+{
+    auto batchContext = static_cast<BatchInstallContext *>(context);
+    if (batchContext->results[index] != ERR_OK) {
+        return;
+    }
+    // each hap is verified and extracted as usual, by an installer of its own
+    BundleInstaller installer(batchContext->codeDirPath, batchContext->dataDirPath);
+    std::vector<BatchInstallItem> &items = batchContext->items[index];
+    installer.batchItems_ = &items;
+    batchContext->results[index] = installer.Install(batchContext->paths[index], *(batchContext->installParam));
+    if (batchContext->results[index] == ERR_OK && !items.empty()) {
+        items.back().index = index;
+    }
+}
+
+void BundleInstaller::CommitBatch(const std::vector<BatchInstallItem> &items, uint8_t results[])
+{
+    if (items.empty()) {
+        return;
+    }
+    std::vector<InstallRecord> records;
+    std::vector<uint8_t> hapTypes;
+    for (const auto &item : items) {
+        records.push_back(item.record);
+        hapTypes.push_back(item.hapType);
+    }
+
+    // as few transactions of the install journal as fit the batch, a failed one rolls back only its bundles
+    uint32_t num = static_cast<uint32_t>(records.size());
+    for (uint32_t offset = 0; offset < num;) {
+        uint32_t commitNum = InstallJournal::GetInstallCommitNum(records.data() + offset, hapTypes.data() + offset,
+            num - offset);
+        // a record which does not fit on its own is still committed, to be rejected and rolled back
+        commitNum = (commitNum == 0) ? 1 : commitNum;
+        if (!InstallJournal::GetInstance().CommitInstall(records.data() + offset, hapTypes.data() + offset,
+            commitNum)) {
+            RollbackBatch(items, offset, commitNum, results);
+        }
+        offset += commitNum;
+    }
+}
+
+void BundleInstaller::RollbackBatch(const std::vector<BatchInstallItem> &items, uint32_t offset, uint32_t num,
+    uint8_t results[])
+{
+    for (uint32_t i = offset; i < offset + num; i++) {
+        const BatchInstallItem &item = items[i];
+        const char *bundleName = item.record.bundleName;
+        HILOG_ERROR(HILOG_MODULE_APP, "commit %{public}s of batch fail!", bundleName);
+        results[item.index] = ERR_APPEXECFWK_INSTALL_FAILED_RECORD_INFO_ERROR;
+        // bundleName belongs to the bundle info, which is released last
+        ManagerService::GetInstance().RecycleUid(bundleName);
+        BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleName);
+        if (bundleInfo != nullptr) {
+            BundleDaemonClient::GetInstance().RemoveInstallDirectory(bundleInfo->codePath, bundleInfo->dataPath,
+                false);
+            ManagerService::GetInstance().RemoveBundleInfo(bundleName);
+        }
+    }
+}
+
+uint8_t BundleInstaller::RebuildHapFromPatch(const char *patchPath, const char *randStr, std::string &hapPath)
+{
+    HapPatch hapPatch(patchPath);
+    if (!hapPatch.Open()) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_BAD_FILE;
+    }
+    const HapPatchHeader &header = hapPatch.GetHeader();
+    BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(header.bundleName.c_str());
+    if (bundleInfo == nullptr || bundleInfo->codePath == nullptr || bundleInfo->moduleInfos == nullptr ||
+        bundleInfo->numOfModule <= 0 || bundleInfo->moduleInfos[0].moduleName == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "base bundle of patch is not installed!");
+        return ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
+    }
+    if (bundleInfo->versionCode != header.baseVersionCode) {
+        HILOG_ERROR(HILOG_MODULE_APP, "patch is not made for the installed version %{public}d",
+            bundleInfo->versionCode);
+        return ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
+    }
+    std::string baseCodePath = std::string(bundleInfo->codePath) + PATH_SEPARATOR +
+        bundleInfo->moduleInfos[0].moduleName;
+    // next to the installed bundle, where the daemon may write and an archive install can link it from
+    hapPath = std::string(bundleInfo->codePath) + randStr + INSTALL_FILE_SUFFIX;
+    if (BundleDaemonClient::GetInstance().ApplyHapPatch(patchPath, baseCodePath.c_str(), hapPath.c_str()) !=
+        EC_SUCCESS) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_BAD_FILE;
+    }
+    trace_.AddIo(0, header.targetSize, 1);
     return ERR_OK;
 }
 
+static void ExtractHapToTmpPath(HapExtractTask &task)
+{
+    uint64_t startTime = InstallTrace::GetCurrentTime();
+    if (task.isUpdate) {
+        task.result = BundleDaemonClient::GetInstance().ExtractHapUpdate(task.hapPath.c_str(),
+            task.tmpCodePath.c_str(), task.codePath.c_str(), task.isArchiveMode, &task.stats);
+    } else if (task.isArchiveMode) {
+        task.result = BundleDaemonClient::GetInstance().ExtractHapArchive(task.hapPath.c_str(),
+            task.tmpCodePath.c_str(), &task.stats);
+    } else {
+        task.result = BundleDaemonClient::GetInstance().ExtractHap(task.hapPath.c_str(), task.tmpCodePath.c_str(),
+            &task.stats);
+    }
+    task.cost = InstallTrace::GetCurrentTime() - startTime;
+}
+
+static void *ExtractHapRoutine(void *arg)
+{
+    ExtractHapToTmpPath(*static_cast<HapExtractTask *>(arg));
+    return nullptr;
+}
+
+static void DropHapPageCache(const std::string &path)
+{
+    int32_t fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        AdviseFileDrop(fd, 0, 0);
+        close(fd);
+    }
+}
+
 uint8_t BundleInstaller::ProcessBundleInstall(const std::string &path, const char *randStr,
     InstallRecord &installRecord, uint8_t hapType)
 {
@@ -176,68 +350,116 @@ uint8_t BundleInstaller::ProcessBundleInstall(const std::string &path, const cha
     // check path
     uint8_t errorCode = CheckInstallFileIsValid(const_cast<char *>(path.c_str()));
     CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    // verify signature
+    // read the hap ahead into the page cache, for the parser, the verifier and the extractor below
+    HapReadPass readPass(path);
+    bool isReadAhead = readPass.Run();
+    trace_.AddIo(readPass.GetBytesRead(), 0, 0);
+    // parse config.json before verifying, so that the hap can be extracted while its signature is verified
+    trace_.BeginPhase(INSTALL_PHASE_PARSE);
+    BundleParser bundleParser;
+    uint8_t parseResult = bundleParser.ParseHapProfile(path, codeDirPath_, dataDirPath_, permissions, bundleRes,
+        &bundleInfo);
+    HapExtractTask extractTask;
+    std::string codePath;
+    pthread_t extractThread;
+    bool isExtracting = false;
+    if (parseResult == ERR_OK) {
+        trace_.SetBundleName(bundleInfo->bundleName);
+        // an update stays in the code path of the installed version, see CheckVersionAndSignature
+        BundleInfo *oldBundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleInfo->bundleName);
+        const char *bundleCodePath = (oldBundleInfo != nullptr && oldBundleInfo->codePath != nullptr) ?
+            oldBundleInfo->codePath : bundleInfo->codePath;
+        codePath = std::string(bundleCodePath) + PATH_SEPARATOR + bundleInfo->moduleInfos[0].moduleName;
+        extractTask.hapPath = path;
+        extractTask.tmpCodePath = codePath + randStr;
+        extractTask.codePath = codePath;
+        extractTask.isUpdate = (oldBundleInfo != nullptr);
+        extractTask.isArchiveMode = ManagerService::GetInstance().IsArchiveInstallMode();
+        // the extraction is only staged in tmpCodePath, it is discarded unless every check below passes
+        isExtracting = (pthread_create(&extractThread, nullptr, ExtractHapRoutine, &extractTask) == 0);
+    }
+    // verify signature, which reads the whole hap
+    trace_.BeginPhase(INSTALL_PHASE_VERIFY);
+    if (!isReadAhead) {
+        trace_.AddIo(BundleUtil::GetFileSize(path.c_str()), 0, 0);
+    }
+    const HapFileKey *fileKey = isReadAhead ? &readPass.GetFileKey() : nullptr;
     SignatureInfo signatureInfo;
 #ifdef OHOS_DEBUG
     if (ManagerService::GetInstance().IsSignMode()) {
-        errorCode = HapSignVerify::VerifySignature(path, signatureInfo);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+        errorCode = HapSignVerify::VerifySignature(path, signatureInfo, fileKey);
     }
 #else
-    errorCode = HapSignVerify::VerifySignature(path, signatureInfo);
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    errorCode = HapSignVerify::VerifySignature(path, signatureInfo, fileKey);
 #endif
-    // parse config.json
-    BundleParser bundleParser;
-    errorCode = bundleParser.ParseHapProfile(path, permissions, bundleRes, &bundleInfo);
+    trace_.EndPhase();
+    if (isExtracting) {
+        pthread_join(extractThread, nullptr);
+        DropHapPageCache(path);
+    } else if (isReadAhead && parseResult != ERR_OK) {
+        DropHapPageCache(path);
+    }
+    // a signature error is reported before a profile error, as it was when verifying came first
+    errorCode = (errorCode == ERR_OK) ? parseResult : errorCode;
+    if (errorCode != ERR_OK && isExtracting) {
+        BundleDaemonClient::GetInstance().RemoveFile(extractTask.tmpCodePath.c_str());
+    }
     CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    std::string tmpCodePath = extractTask.tmpCodePath;
+    trace_.BeginPhase(INSTALL_PHASE_VERIFY);
 #ifdef OHOS_DEBUG
     // check signatureInfo
     if (ManagerService::GetInstance().IsSignMode()) {
         errorCode = CheckProvisionInfoIsValid(signatureInfo, permissions, bundleInfo->bundleName);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+        CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
         // check version and signature when in update status
         errorCode = ReshapeAppId(bundleInfo->bundleName, signatureInfo.appId);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+        CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
         bundleInfo->appId = Utils::Strdup(signatureInfo.appId.c_str());
     } else {
         bundleInfo->appId = Utils::Strdup(APPID);
     }
 #else
     errorCode = CheckProvisionInfoIsValid(signatureInfo, permissions, bundleInfo->bundleName);
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
     // check version and signature when in update status
     errorCode = ReshapeAppId(bundleInfo->bundleName, signatureInfo.appId);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
     bundleInfo->appId = Utils::Strdup(signatureInfo.appId.c_str());
 #endif
     errorCode = (bundleInfo->appId == nullptr) ? ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR : ERR_OK;
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
     installRecord.bundleName = bundleInfo->bundleName;
     installRecord.appId = bundleInfo->appId;
     installRecord.versionCode = bundleInfo->versionCode;
     errorCode = CheckVersionAndSignature(installRecord.bundleName, bundleInfo);
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    std::string codePath = std::string(bundleInfo->codePath) + PATH_SEPARATOR + bundleInfo->moduleInfos[0].moduleName;
+    CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
     installRecord.codePath = bundleInfo->codePath;
-    // unzip bundle
-    std::string tmpCodePath = codePath + randStr;
-    errorCode = (BundleDaemonClient::GetInstance().ExtractHap(path.c_str(), tmpCodePath.c_str()) == EC_SUCCESS) ?
-        ERR_OK : ERR_APPEXECFWK_INSTALL_FAILED_EXTRACT_HAP_ERROR;
+    // unzip bundle, an update only extracts the entries which changed since the installed version
+    trace_.EndPhase();
+    if (!isExtracting) {
+        ExtractHapToTmpPath(extractTask);
+        DropHapPageCache(path);
+    }
+    trace_.AddPhaseCost(INSTALL_PHASE_EXTRACT, static_cast<uint32_t>(extractTask.cost));
+    trace_.AddIo(extractTask.stats.bytesRead, extractTask.stats.bytesWritten, extractTask.stats.fileCount);
+    errorCode = (extractTask.result == EC_SUCCESS) ? ERR_OK : ERR_APPEXECFWK_INSTALL_FAILED_EXTRACT_HAP_ERROR;
     CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
     // rename install path and record install infomation
-    bool isUpdate = ManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName) != nullptr;
+    bool isUpdate = extractTask.isUpdate;
+    trace_.BeginPhase(INSTALL_PHASE_RECORD);
     errorCode = HandleFileAndBackUpRecord(codePath.c_str(), randStr, installRecord, isUpdate, hapType);
-    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes, randStr);
+    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes);
     bundleInfo->uid = installRecord.uid;
     bundleInfo->gid = installRecord.uid;
     // store permissions
+    trace_.BeginPhase(INSTALL_PHASE_PERMISSION);
     errorCode = StorePermissions(installRecord.bundleName, permissions.permissionTrans, permissions.permNum,
         isUpdate);
-    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes, randStr);
+    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes);
     // update bundle Info
     errorCode = UpdateBundleInfo(installRecord.appId, bundleRes, bundleInfo, isUpdate, hapType);
-    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes, randStr);
+    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes);
     // free permissions
     AdapterFree(permissions.permissionTrans);
     AdapterFree(bundleRes.abilityRes);
@@ -386,10 +608,6 @@ uint8_t BundleInstaller::HandleFileAndBackUpRecord(const char *codePath, const c
         record.uid = bundleInfo->uid;
         record.gid = bundleInfo->gid;
     }
-    std::string bundleTmpJsonPath = std::string(JSON_PATH) + record.bundleName + randStr + JSON_SUFFIX;
-    if (!BackUpInstallRecord(record, bundleTmpJsonPath.c_str())) {
-        return ERR_APPEXECFWK_INSTALL_FAILED_RECORD_INFO_ERROR;
-    }
     return ERR_OK;
 }
 
@@ -399,10 +617,12 @@ uint8_t BundleInstaller::UpdateBundleInfo(const char *appId, const BundleRes &bu
     if ((appId == nullptr) || (bundleInfo == nullptr)) {
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
+    trace_.BeginPhase(INSTALL_PHASE_TRANSFORM);
     uint8_t errorCode = BundleResTransform::ConvertResInfoToBundleInfo(bundleInfo->codePath, bundleRes, bundleInfo);
     if (errorCode != ERR_OK) {
         return errorCode;
     }
+    trace_.BeginPhase(INSTALL_PHASE_RECORD);
     if (!isUpdate) {
         bundleInfo->isSystemApp = (hapType == SYSTEM_APP_FLAG);
     } else {
@@ -461,47 +681,15 @@ uint8_t BundleInstaller::Uninstall(const char *bundleName, const InstallParam &i
         return ERR_APPEXECFWK_UNINSTALL_FAILED_DELETE_PERMISSIONS_ERROR;
     }
 
-    // delete uid and gid info
-    if (!BundleUtil::DeleteUidInfoFromJson(bundleName)) {
-        return ERR_APPEXECFWK_UNINSTALL_FAILED_DELETE_UID_INFO_ERROR;
-    }
-
-    std::string bundleJsonPath = std::string(JSON_PATH) + bundleName + JSON_SUFFIX;
-    if (BundleDaemonClient::GetInstance().RemoveFile(bundleJsonPath.c_str()) != EC_SUCCESS) {
+    // the install record and the uid of the bundle go with the next checkpoint of the install journal, so does
+    // the mark which keeps an uninstalled third system bundle from being installed again at boot
+    InstallJournal &journal = InstallJournal::GetInstance();
+    if (!journal.CommitUninstall(bundleName, journal.IsThirdSystemBundle(bundleName))) {
         return ERR_APPEXECFWK_UNINSTALL_FAILED_DELETE_RECORD_INFO_ERROR;
     }
-
-    if (CheckIsThirdSystemBundle(bundleName)) {
-        RecordThirdSystemBundle(bundleName, UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON);
-    }
     return ERR_OK;
 }
 
-bool BundleInstaller::BackUpUidAndGidInfo(const InstallRecord &record, const char *jsonPath)
-{
-    if (jsonPath == nullptr) {
-        return false;
-    }
-    cJSON *object = BundleUtil::ConvertUidAndGidToJson(record);
-    if (object == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "BackUpUidAndGidInfo fail, object is null!");
-        return false;
-    }
-
-    char *buffer = cJSON_Print(object);
-    cJSON_Delete(object);
-    if (buffer == nullptr) {
-        return false;
-    }
-    if (BundleDaemonClient::GetInstance().StoreContentToFile(jsonPath, buffer, strlen(buffer) + 1) != EC_SUCCESS) {
-        HILOG_ERROR(HILOG_MODULE_APP, "BackUpUidAndGidInfo fail, beacuse store JsonContent fail!");
-        cJSON_free(buffer);
-        return false;
-    }
-    cJSON_free(buffer);
-    return true;
-}
-
 uint8_t BundleInstaller::CheckInstallFileIsValid(const char *path)
 {
     if (path == nullptr) {
@@ -522,158 +710,6 @@ uint8_t BundleInstaller::CheckInstallFileIsValid(const char *path)
     return ERR_OK;
 }
 
-bool BundleInstaller::CheckIsThirdSystemBundle(const char *bundleName)
-{
-    if (bundleName == nullptr) {
-        return false;
-    }
-
-    cJSON *root = BundleUtil::GetJsonStream(THIRD_SYSTEM_BUNDLE_JSON);
-    if (root == nullptr) {
-        return false;
-    }
-
-    cJSON *son = cJSON_GetObjectItem(root, JSON_MAIN_KEY);
-    if (!cJSON_IsArray(son)) {
-        BundleDaemonClient::GetInstance().RemoveFile(THIRD_SYSTEM_BUNDLE_JSON);
-        cJSON_Delete(root);
-        return false;
-    }
-
-    cJSON *item = nullptr;
-    cJSON_ArrayForEach(item, son) {
-        if (!cJSON_IsString(item)) {
-            cJSON_Delete(root);
-            return false;
-        }
-        if (item->valuestring != nullptr && strcmp(bundleName, item->valuestring) == 0) {
-            cJSON_Delete(root);
-            return true;
-        }
-    }
-    cJSON_Delete(root);
-    return false;
-}
-
-void BundleInstaller::RecordThirdSystemBundle(const char *bundleName, const char *path)
-{
-    if ((bundleName == nullptr) || (path == nullptr)) {
-        return;
-    }
-
-    if (!BundleUtil::IsFile(path)) {
-        InitThirdSystemBundleRecord(bundleName, path);
-        return;
-    }
-    cJSON *root = BundleUtil::GetJsonStream(path);
-    if (root == nullptr) {
-        return;
-    }
-
-    cJSON *son = cJSON_GetObjectItem(root, JSON_MAIN_KEY);
-    if (!cJSON_IsArray(son)) {
-        BundleDaemonClient::GetInstance().RemoveFile(path);
-        cJSON_Delete(root);
-        InitThirdSystemBundleRecord(bundleName, path);
-        return;
-    }
-
-    cJSON *str = cJSON_CreateString(bundleName);
-    if (str == nullptr) {
-        cJSON_Delete(root);
-        return;
-    }
-
-    if (!cJSON_AddItemToArray(son, str)) {
-        cJSON_Delete(str);
-        cJSON_Delete(root);
-        return;
-    }
-
-    char *buffer = cJSON_Print(root);
-    cJSON_Delete(root);
-    if (buffer == nullptr) {
-        return;
-    }
-
-    if (BundleDaemonClient::GetInstance().StoreContentToFile(path, buffer, strlen(buffer) + 1) != EC_SUCCESS) {
-        HILOG_ERROR(HILOG_MODULE_APP, "record third system bundle install info fail!");
-    }
-    cJSON_free(buffer);
-}
-
-void BundleInstaller::InitThirdSystemBundleRecord(const char *bundleName, const char *path)
-{
-    if (bundleName == nullptr || path == nullptr) {
-        return;
-    }
-
-    cJSON *root = cJSON_CreateObject();
-    if (root == nullptr) {
-        return;
-    }
-
-    cJSON *son = cJSON_CreateArray();
-    if (son == nullptr) {
-        cJSON_Delete(root);
-        return;
-    }
-
-    if (!cJSON_AddItemToObject(root, JSON_MAIN_KEY, son)) {
-        cJSON_Delete(son);
-        cJSON_Delete(root);
-        return;
-    }
-
-    cJSON *str = cJSON_CreateString(bundleName);
-    if (str == nullptr) {
-        cJSON_Delete(root);
-        return;
-    }
-
-    if (!cJSON_AddItemToArray(son, str)) {
-        cJSON_Delete(str);
-        cJSON_Delete(root);
-        return;
-    }
-
-    char *buffer = cJSON_Print(root);
-    cJSON_Delete(root);
-    if (buffer == nullptr) {
-        return;
-    }
-
-    if (BundleDaemonClient::GetInstance().StoreContentToFile(path, buffer, strlen(buffer) + 1) != EC_SUCCESS) {
-        HILOG_ERROR(HILOG_MODULE_APP, "init Third System Bundle Record fail!");
-    }
-    cJSON_free(buffer);
-}
-
-bool BundleInstaller::BackUpInstallRecord(const InstallRecord &record, const char *jsonPath)
-{
-    if (jsonPath == nullptr) {
-        return false;
-    }
-    cJSON *object = BundleUtil::ConvertInstallRecordToJson(record);
-    if (object == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "BackUpInstallRecord fail, beacuse convertInstallRecordToJson object is null!");
-        return false;
-    }
-
-    char *buffer = cJSON_Print(object);
-    cJSON_Delete(object);
-    if (buffer == nullptr) {
-        return false;
-    }
-    if (BundleDaemonClient::GetInstance().StoreContentToFile(jsonPath, buffer, strlen(buffer) + 1) != EC_SUCCESS) {
-        HILOG_ERROR(HILOG_MODULE_APP, "BackUpInstallRecord fail, beacuse store Json Content fail!");
-        cJSON_free(buffer);
-        return false;
-    }
-    cJSON_free(buffer);
-    return true;
-}
-
 uint8_t BundleInstaller::StorePermissions(const char *bundleName, PermissionTrans *permissions, int32_t permNum,
     bool isUpdate)
 {
@@ -728,18 +764,4 @@ uint8_t BundleInstaller::CheckVersionAndSignature(const char *bundleName, Bundle
     }
     return ERR_OK;
 }
-
-bool BundleInstaller::RenameJsonFile(const char *fileName, const char *randStr)
-{
-    if (fileName == nullptr || randStr == nullptr) {
-        return false;
-    }
-
-    std::string tmpJsonPath = std::string(JSON_PATH) + fileName + randStr + JSON_SUFFIX;
-    std::string jsonPath = std::string(JSON_PATH) + fileName + JSON_SUFFIX;
-    if (BundleDaemonClient::GetInstance().RenameFile(tmpJsonPath.c_str(), jsonPath.c_str()) != EC_SUCCESS) {
-        return false;
-    }
-    return true;
-}
 } // namespace OHOS
@@ -27,6 +27,7 @@ extern "C" {
 #include <algorithm>
 #include <dirent.h>
 #include <pthread.h>
+#include <set>
 #include <unistd.h>
 
 #include "appexecfwk_errors.h"
@@ -38,7 +39,13 @@ extern "C" {
 #include "bundle_manager.h"
 #include "bundle_message_id.h"
 #include "bundle_parser.h"
+#include "bundle_registry_snapshot.h"
+#include "bundle_scan_pool.h"
 #include "bundle_util.h"
+#include "hap_patch.h"
+#include "install_journal.h"
+#include "install_record_store.h"
+#include "install_trace.h"
 #include "ipc_skeleton.h"
 #include "rpc_errno.h"
 #include "log.h"
@@ -47,10 +54,57 @@ extern "C" {
 #include "want.h"
 
 namespace OHOS {
-ManagerService::ManagerService()
+#ifdef APPEXECFWK_INSTALL_CONCURRENCY
+// the number of bundles installed or uninstalled at the same time, see appexecfwk_lite_install_concurrency
+constexpr uint32_t INSTALL_WORK_CONCURRENCY = APPEXECFWK_INSTALL_CONCURRENCY;
+#else
+constexpr uint32_t INSTALL_WORK_CONCURRENCY = 1;
+#endif
+#ifdef APPEXECFWK_LAZY_REGISTRY
+// boot registers a stub per installed bundle, its profiles are parsed when it is first asked for
+constexpr bool LAZY_REGISTRY = true;
+#else
+constexpr bool LAZY_REGISTRY = false;
+#endif
+
+struct BatchInstallWork {
+    BatchInstallInfo info;
+    std::vector<char *> bundleNames;
+    std::vector<uint8_t> results;
+};
+
+enum BootScanAction : uint8_t {
+    BOOT_SCAN_SKIP = 0,
+    BOOT_SCAN_RELOAD,
+    BOOT_SCAN_INSTALL,
+    BOOT_SCAN_RELOAD_AND_INSTALL,
+};
+
+// one hap or installed bundle directory found at boot, checked and parsed off the service thread
+struct BootScanItem {
+    std::string appPath;
+    std::string bundleName;
+    uint8_t scanFlag = THIRD_APP_FLAG;
+    BootScanAction action = BOOT_SCAN_SKIP;
+    std::string codePath;
+    std::string appId;
+    int32_t recordVersionCode = -1;
+    int32_t uid = INVALID_UID;
+    // bundleInfos holds a single stub, see BundleMap::AddStub
+    bool isStub = false;
+    std::vector<BundleInfo *> bundleInfos;
+    std::vector<std::string> invalidProfileDirs;
+};
+
+struct BootScanContext {
+    std::vector<BootScanItem> *items;
+};
+
+ManagerService::ManagerService() : workQueue_(INSTALL_WORK_CONCURRENCY, ProcessBundleWork)
 {
     installer_ = new BundleInstaller(INSTALL_PATH, DATA_PATH);
     bundleMap_ = BundleMap::GetInstance();
+    bundleMap_->SetLoader(LoadBundleInfo);
 }
 
 ManagerService::~ManagerService()
@@ -92,7 +146,7 @@ static void InnerTransact(uint32_t code, uint8_t resultCode, const char *bundleN
     }
 }
 
-static void InnerSelfTransact(uint32_t code, uint8_t resultCode, const SvcIdentity &svc)
+static void InnerSelfTransact(uint32_t code, uint8_t resultCode, const SvcIdentity &svc, bool releaseSvc = true)
 {
     IpcIo io;
     char data[MAX_IO_SIZE];
@@ -107,12 +161,18 @@ static void InnerSelfTransact(uint32_t code, uint8_t resultCode, const SvcIdenti
     if (ret != ERR_NONE) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleMS InnerSelfTransact failed %{public}d\n", ret);
     }
-    ReleaseSvc(svc);
+    if (releaseSvc) {
+        ReleaseSvc(svc);
+    }
 }
 
 std::vector<SvcIdentity> ManagerService::GetServiceId() const
 {
-    return svcIdentity_;
+    // read by the install workers, changed on the service task
+    pthread_mutex_lock(&svcMutex_);
+    std::vector<SvcIdentity> svcIdentity = svcIdentity_;
+    pthread_mutex_unlock(&svcMutex_);
+    return svcIdentity;
 }
 
 bool ManagerService::GetAmsInterface(AmsInnerInterface **amsInterface)
@@ -161,6 +221,18 @@ bool ManagerService::IsDebugMode() const
     return isDebugMode_;
 }
 
+uint8_t ManagerService::SetArchiveInstallMode(bool enable)
+{
+    isArchiveInstallMode_ = enable;
+    HILOG_INFO(HILOG_MODULE_APP, "current archive install mode is %d", isArchiveInstallMode_);
+    return ERR_OK;
+}
+
+bool ManagerService::IsArchiveInstallMode() const
+{
+    return isArchiveInstallMode_;
+}
+
 #ifdef OHOS_DEBUG
 uint8_t ManagerService::SetSignMode(bool enable)
 {
@@ -175,6 +247,53 @@ bool ManagerService::IsSignMode() const
 }
 #endif
 
+static int8_t ParsePatchBundleName(const char *path, char **bundleName)
+{
+    HapPatch hapPatch(path);
+    if (!hapPatch.Open()) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_BAD_FILE;
+    }
+    *bundleName = Utils::Strdup(hapPatch.GetHeader().bundleName.c_str());
+    return (*bundleName == nullptr) ? ERR_APPEXECFWK_INSTALL_FAILED_PARSE_BUNDLENAME_ERROR : ERR_OK;
+}
+
+static int8_t ParseInstallBundleName(const char *path, char **bundleName)
+{
+    int32_t versionCode = -1;
+    // a patch names the bundle it updates in its header, the hap it describes does not exist yet
+    return BundleUtil::EndWith(path, PATCH_FILE_SUFFIX) ? ParsePatchBundleName(path, bundleName) :
+        BundleParser::ParseBundleParam(path, bundleName, versionCode);
+}
+
+// a queued install is known by the real path of its hap, its bundle name is parsed by the worker that runs it
+static std::string GetInstallWorkKey(const char *path)
+{
+    char realPath[PATH_MAX + 1] = { 0 };
+    if (strlen(path) > PATH_MAX || realpath(path, realPath) == nullptr) {
+        return path;
+    }
+    return realPath;
+}
+
+// a hap whose bundle name cannot be parsed, or whose bundle is named by an earlier hap of the batch, fails
+static void ParseBatchBundleNames(BatchInstallWork &batchWork, std::vector<std::string> &bundleNames)
+{
+    for (int32_t i = 0; i < batchWork.info.num; i++) {
+        int8_t ret = (batchWork.info.paths[i] == nullptr) ? ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR :
+            ParseInstallBundleName(batchWork.info.paths[i], &batchWork.bundleNames[i]);
+        if (ret != ERR_OK) {
+            batchWork.results[i] = static_cast<uint8_t>(ret);
+            continue;
+        }
+        // a second hap of the same bundle would update a bundle that is not committed yet
+        if (std::find(bundleNames.begin(), bundleNames.end(), batchWork.bundleNames[i]) != bundleNames.end()) {
+            batchWork.results[i] = ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
+            continue;
+        }
+        bundleNames.emplace_back(batchWork.bundleNames[i]);
+    }
+}
+
 void ManagerService::ServiceMsgProcess(Request* request)
 {
     if (request == nullptr) {
@@ -185,39 +304,23 @@ void ManagerService::ServiceMsgProcess(Request* request)
         installer_ = new BundleInstaller(INSTALL_PATH, DATA_PATH);
     }
 
+    // the request data is released once this returns, a queued work keeps its own copy
+    BundleWork work;
+    work.msgId = request->msgId;
     switch (request->msgId) {
         case BUNDLE_SERVICE_INITED: {
-            if (!BundleDaemonClient::GetInstance().Initialize()) {
-                HILOG_ERROR(HILOG_MODULE_APP, "BundleDeamonClient initialize fail");
-                return;
-            }
-            ScanPackages();
-            ScanSharedLibPath();
-            AmsInnerInterface *amsInterface = nullptr;
-            if (!GetAmsInterface(&amsInterface)) {
-                return;
-            }
-            if (amsInterface != nullptr) {
-                amsInterface->StartKeepAliveApps();
-            }
+            work.priority = WORK_PRIORITY_INTERACTIVE;
+            work.exclusive = true;
             break;
         }
         case BUNDLE_UPDATED:
             /* Process update request by Install() */
         case BUNDLE_INSTALLED: {
             auto info = reinterpret_cast<SvcIdentityInfo *>(request->data);
-            if (info == nullptr) {
+            if (!PrepareInstallWork(info, work)) {
                 return;
             }
-            if (info->svc == nullptr || info->path == nullptr) {
-                AdapterFree(info->path);
-                AdapterFree(info->svc);
-                return;
-            }
-
-            InstallThirdBundle(info->path, *(info->svc), info->installLocation);
-            AdapterFree(info->path);
-            AdapterFree(info->svc);
+            work.priority = (request->msgId == BUNDLE_INSTALLED) ? WORK_PRIORITY_INTERACTIVE : WORK_PRIORITY_NORMAL;
             break;
         }
         case BUNDLE_UNINSTALLED: {
@@ -230,16 +333,22 @@ void ManagerService::ServiceMsgProcess(Request* request)
                 AdapterFree(info->svc);
                 return;
             }
-
-            InstallParam installParam = {.installLocation = 1, .keepData = info->keepData};
-            uint8_t bResult = installer_->Uninstall(info->bundleName, installParam);
-            InnerSelfTransact(UNINSTALL_CALLBACK, bResult, *(info->svc));
-            InnerTransact(UNINSTALL_CALLBACK, bResult, info->bundleName);
-            if (bResult == ERR_OK) {
-                RecycleUid(info->bundleName);
+            work.priority = WORK_PRIORITY_INTERACTIVE;
+            work.bundleNames.emplace_back(info->bundleName);
+            work.data = new (std::nothrow) SvcIdentityInfo(*info);
+            if (work.data == nullptr) {
+                AdapterFree(info->bundleName);
+                AdapterFree(info->svc);
+                return;
             }
-            AdapterFree(info->bundleName);
-            AdapterFree(info->svc);
+            break;
+        }
+        case BUNDLE_BATCH_INSTALLED: {
+            auto info = reinterpret_cast<BatchInstallInfo *>(request->data);
+            if (!PrepareBatchInstallWork(info, work)) {
+                return;
+            }
+            work.priority = WORK_PRIORITY_BACKGROUND;
             break;
         }
         case BUNDLE_CHANGE_CALLBACK: {
@@ -252,12 +361,140 @@ void ManagerService::ServiceMsgProcess(Request* request)
             } else {
                 RemoveCallbackServiceId(*svc);
             }
+            return;
+        }
+        default: {
+            return;
+        }
+    }
+    if (!workQueue_.Push(std::move(work))) {
+        HILOG_WARN(HILOG_MODULE_APP, "BundleMS push work fail, process it in place");
+        ProcessBundleWork(work);
+    }
+}
+
+bool ManagerService::PrepareInstallWork(SvcIdentityInfo *info, BundleWork &work)
+{
+    if (info == nullptr) {
+        return false;
+    }
+    if (info->svc == nullptr || info->path == nullptr) {
+        AdapterFree(info->path);
+        AdapterFree(info->svc);
+        return false;
+    }
+    auto installInfo = new (std::nothrow) SvcIdentityInfo(*info);
+    if (installInfo == nullptr) {
+        AdapterFree(info->path);
+        AdapterFree(info->svc);
+        return false;
+    }
+    installInfo->bundleName = nullptr;
+    work.bundleNames.emplace_back(GetInstallWorkKey(info->path));
+    work.data = installInfo;
+    return true;
+}
+
+bool ManagerService::PrepareBatchInstallWork(BatchInstallInfo *info, BundleWork &work)
+{
+    if (info == nullptr) {
+        return false;
+    }
+    auto batchWork = new (std::nothrow) BatchInstallWork();
+    if (info->svc == nullptr || info->paths == nullptr || info->num <= 0 || info->num > MAX_INSTALL_BATCH_NUM ||
+        batchWork == nullptr) {
+        for (int32_t i = 0; (info->paths != nullptr) && (i < info->num); i++) {
+            AdapterFree(info->paths[i]);
+        }
+        AdapterFree(info->paths);
+        AdapterFree(info->svc);
+        delete batchWork;
+        return false;
+    }
+    batchWork->info = *info;
+    batchWork->bundleNames.resize(info->num, nullptr);
+    batchWork->results.resize(info->num, ERR_OK);
+    for (int32_t i = 0; i < info->num; i++) {
+        if (info->paths[i] != nullptr) {
+            work.bundleNames.emplace_back(GetInstallWorkKey(info->paths[i]));
+        }
+    }
+    work.data = batchWork;
+    return true;
+}
+
+void ManagerService::ProcessBundleWork(BundleWork &work)
+{
+    ManagerService &service = GetInstance();
+    switch (work.msgId) {
+        case BUNDLE_SERVICE_INITED: {
+            service.InitializeBundles();
+            break;
+        }
+        case BUNDLE_UPDATED:
+        case BUNDLE_INSTALLED: {
+            auto info = static_cast<SvcIdentityInfo *>(work.data);
+            service.InstallThirdBundle(info->path, *(info->svc), info->installLocation);
+            AdapterFree(info->path);
+            AdapterFree(info->svc);
+            delete info;
+            break;
+        }
+        case BUNDLE_UNINSTALLED: {
+            auto info = static_cast<SvcIdentityInfo *>(work.data);
+            service.UninstallThirdBundle(info->bundleName, *(info->svc), info->keepData);
+            AdapterFree(info->bundleName);
+            AdapterFree(info->svc);
+            delete info;
+            break;
+        }
+        case BUNDLE_BATCH_INSTALLED: {
+            auto batchWork = static_cast<BatchInstallWork *>(work.data);
+            service.InstallThirdBundles(*batchWork);
+            for (int32_t i = 0; i < batchWork->info.num; i++) {
+                AdapterFree(batchWork->info.paths[i]);
+                AdapterFree(batchWork->bundleNames[i]);
+            }
+            AdapterFree(batchWork->info.paths);
+            AdapterFree(batchWork->info.svc);
+            delete batchWork;
             break;
         }
         default: {
             break;
         }
     }
+    work.data = nullptr;
+}
+
+void ManagerService::InitializeBundles()
+{
+    if (!BundleDaemonClient::GetInstance().Initialize()) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleDeamonClient initialize fail");
+        return;
+    }
+    ScanPackages();
+    ScanSharedLibPath();
+    AmsInnerInterface *amsInterface = nullptr;
+    if (!GetAmsInterface(&amsInterface)) {
+        return;
+    }
+    if (amsInterface != nullptr) {
+        amsInterface->StartKeepAliveApps();
+    }
+}
+
+void ManagerService::UninstallThirdBundle(const char *bundleName, const SvcIdentity &svc, bool keepData)
+{
+    InstallParam installParam = {.installLocation = 1, .keepData = keepData};
+    BundleInstaller installer(INSTALL_PATH, DATA_PATH);
+    uint8_t bResult = installer.Uninstall(bundleName, installParam);
+    InnerSelfTransact(UNINSTALL_CALLBACK, bResult, svc);
+    InnerTransact(UNINSTALL_CALLBACK, bResult, bundleName);
+    if (bResult == ERR_OK) {
+        RecycleUid(bundleName);
+        (void) BundleRegistrySnapshot::GetInstance().Save(*bundleMap_);
+    }
 }
 
 static bool CompareServiceId(const SvcIdentity &svc1, const SvcIdentity &svc2)
@@ -267,66 +504,176 @@ static bool CompareServiceId(const SvcIdentity &svc1, const SvcIdentity &svc2)
 
 void ManagerService::AddCallbackServiceId(const SvcIdentity &svc)
 {
+    pthread_mutex_lock(&svcMutex_);
     for (auto it = svcIdentity_.begin(); it != svcIdentity_.end(); ++it) {
         if (CompareServiceId(*it, svc)) {
+            pthread_mutex_unlock(&svcMutex_);
             return;
         }
     }
     svcIdentity_.emplace_back(svc);
+    pthread_mutex_unlock(&svcMutex_);
 }
 
 void ManagerService::RemoveCallbackServiceId(const SvcIdentity &svc)
 {
     ReleaseSvc(svc);
+    pthread_mutex_lock(&svcMutex_);
     for (auto it = svcIdentity_.begin(); it != svcIdentity_.end(); ++it) {
         if (CompareServiceId(*it, svc)) {
             svcIdentity_.erase(it);
-            return;
+            break;
         }
     }
+    pthread_mutex_unlock(&svcMutex_);
 }
 
 void ManagerService::InstallThirdBundle(const char *path, const SvcIdentity &svc, int32_t installLocation)
 {
-    if (path == nullptr || installer_ == nullptr) {
+    if (path == nullptr) {
+        ReleaseSvc(svc);
         return;
     }
     char *bundleName = nullptr;
-    int32_t versionCode = -1;
-    int8_t ret = BundleParser::ParseBundleParam(path, &bundleName, versionCode);
+    int8_t ret = ParseInstallBundleName(path, &bundleName);
     if (ret != ERR_OK) {
-        InnerSelfTransact(INSTALL_CALLBACK, ret, svc);
         AdapterFree(bundleName);
+        InnerSelfTransact(INSTALL_CALLBACK, ret, svc);
         return;
     }
+    // another hap of the bundle queued under a different path waits for this one
+    std::vector<std::string> bundleNames = { bundleName };
+    workQueue_.AcquireBundles(bundleNames);
     InstallParam installParam = {.installLocation = installLocation, .keepData = false};
-    uint8_t bResult = installer_->Install(path, installParam);
+    BundleInstaller installer(INSTALL_PATH, DATA_PATH);
+    uint8_t bResult = installer.Install(path, installParam);
     HILOG_DEBUG(HILOG_MODULE_APP, "BundleMS InstallThirdBundle Install : %{public}d\n", bResult);
+    if (bResult == ERR_OK) {
+        (void) BundleRegistrySnapshot::GetInstance().Save(*bundleMap_);
+    }
+    workQueue_.ReleaseBundles(bundleNames);
     InnerSelfTransact(INSTALL_CALLBACK, bResult, svc);
     InnerTransact(INSTALL_CALLBACK, bResult, bundleName);
+    AdapterFree(bundleName);
 }
 
-void ManagerService::InstallAllSystemBundle(int32_t scanFlag)
+void ManagerService::InstallThirdBundles(BatchInstallWork &batchWork)
 {
-    DIR *dir = nullptr;
-    dirent *ent = nullptr;
+    const SvcIdentity &svc = *(batchWork.info.svc);
+    int32_t num = batchWork.info.num;
+    std::vector<std::string> bundleNames;
+    ParseBatchBundleNames(batchWork, bundleNames);
+    workQueue_.AcquireBundles(bundleNames);
+    InstallParam installParam = {.installLocation = batchWork.info.installLocation, .keepData = false};
+    BundleInstaller installer(INSTALL_PATH, DATA_PATH);
+    installer.InstallBatch(batchWork.info.paths, batchWork.results.data(), num, installParam);
+    if (std::find(batchWork.results.begin(), batchWork.results.end(), ERR_OK) != batchWork.results.end()) {
+        (void) BundleRegistrySnapshot::GetInstance().Save(*bundleMap_);
+    }
+    workQueue_.ReleaseBundles(bundleNames);
+    for (int32_t i = 0; i < num; i++) {
+        HILOG_DEBUG(HILOG_MODULE_APP, "BundleMS InstallThirdBundles Install %{public}d : %{public}d\n", i,
+            batchWork.results[i]);
+        InnerSelfTransact(INSTALL_CALLBACK, batchWork.results[i], svc, false);
+        InnerTransact(INSTALL_CALLBACK, batchWork.results[i], batchWork.bundleNames[i]);
+    }
+    ReleaseSvc(svc);
+}
+
+static bool AddInstallReportsToJson(cJSON *root)
+{
+    InstallReport reports[MAX_INSTALL_REPORT_NUM];
+    uint32_t num = InstallReportRecorder::GetInstance().GetReports(reports, MAX_INSTALL_REPORT_NUM);
+    cJSON *reportArray = cJSON_AddArrayToObject(root, "installReports");
+    if (reportArray == nullptr) {
+        return false;
+    }
+    // the latest install first, costs are in microseconds
+    for (uint32_t i = 0; i < num; i++) {
+        cJSON *item = cJSON_CreateObject();
+        if (item == nullptr) {
+            return false;
+        }
+        cJSON_AddItemToArray(reportArray, item);
+        if (cJSON_AddStringToObject(item, "bundleName", reports[i].bundleName) == nullptr ||
+            cJSON_AddNumberToObject(item, "result", reports[i].result) == nullptr ||
+            cJSON_AddNumberToObject(item, "totalCost", reports[i].totalCost) == nullptr) {
+            return false;
+        }
+        cJSON *phases = cJSON_AddObjectToObject(item, "phaseCost");
+        if (phases == nullptr) {
+            return false;
+        }
+        for (uint8_t phase = 0; phase < INSTALL_PHASE_NUM; phase++) {
+            if (cJSON_AddNumberToObject(phases, InstallTrace::GetPhaseName(static_cast<InstallPhase>(phase)),
+                reports[i].phaseCost[phase]) == nullptr) {
+                return false;
+            }
+        }
+        if (cJSON_AddNumberToObject(item, "bytesRead", reports[i].bytesRead) == nullptr ||
+            cJSON_AddNumberToObject(item, "bytesWritten", reports[i].bytesWritten) == nullptr ||
+            cJSON_AddNumberToObject(item, "fileCount", reports[i].fileCount) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    dir = (scanFlag == SYSTEM_APP_FLAG) ? opendir(SYSTEM_BUNDLE_PATH) : opendir(THIRD_SYSTEM_BUNDLE_PATH);
+bool ManagerService::DumpInstallState(std::string &state)
+{
+    BundleWorkQueueState queueState;
+    workQueue_.GetState(queueState);
+    cJSON *root = cJSON_CreateObject();
+    if (root == nullptr) {
+        return false;
+    }
+    cJSON *queue = cJSON_AddObjectToObject(root, "installQueue");
+    if (queue == nullptr ||
+        cJSON_AddNumberToObject(queue, "interactive", queueState.pending[WORK_PRIORITY_INTERACTIVE]) == nullptr ||
+        cJSON_AddNumberToObject(queue, "normal", queueState.pending[WORK_PRIORITY_NORMAL]) == nullptr ||
+        cJSON_AddNumberToObject(queue, "background", queueState.pending[WORK_PRIORITY_BACKGROUND]) == nullptr ||
+        cJSON_AddNumberToObject(queue, "running", queueState.running) == nullptr ||
+        cJSON_AddNumberToObject(queue, "concurrency", queueState.concurrency) == nullptr ||
+        !AddInstallReportsToJson(root)) {
+        cJSON_Delete(root);
+        return false;
+    }
+    char *str = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (str == nullptr) {
+        return false;
+    }
+    state = str;
+    cJSON_free(str);
+    return true;
+}
+
+// the entries sorted by name, so that every boot scans and installs in the same order
+static void ListDirEntries(const char *dirPath, std::vector<std::string> &names)
+{
+    DIR *dir = opendir(dirPath);
     if (dir == nullptr) {
         return;
     }
-
+    dirent *ent = nullptr;
     while ((ent = readdir(dir)) != nullptr) {
         if ((strcmp(ent->d_name, ".") == 0) || (strcmp(ent->d_name, "..")) == 0) {
             continue;
         }
-        if (scanFlag == SYSTEM_APP_FLAG) {
-            InstallSystemBundle(SYSTEM_BUNDLE_PATH, ent->d_name);
-        } else {
-            InstallSystemBundle(THIRD_SYSTEM_BUNDLE_PATH, ent->d_name);
-        }
+        names.emplace_back(ent->d_name);
     }
     closedir(dir);
+    std::sort(names.begin(), names.end());
+}
+
+void ManagerService::InstallAllSystemBundle(int32_t scanFlag)
+{
+    const char *fileDir = (scanFlag == SYSTEM_APP_FLAG) ? SYSTEM_BUNDLE_PATH : THIRD_SYSTEM_BUNDLE_PATH;
+    std::vector<std::string> fileNames;
+    ListDirEntries(fileDir, fileNames);
+    for (const auto &fileName : fileNames) {
+        InstallSystemBundle(fileDir, fileName.c_str());
+    }
 }
 
 void ManagerService::InstallSystemBundle(const char *fileDir, const char *fileName)
@@ -346,215 +693,311 @@ void ManagerService::InstallSystemBundle(const char *fileDir, const char *fileNa
 
 void ManagerService::ScanPackages()
 {
+    // bring the install record store up to what was committed before the last shutdown
+    InstallJournal::GetInstance().Recover();
     // restore uid and gid map
     RestoreUidAndGidMap();
 
-    if (!BundleUtil::IsDir(JSON_PATH)) {
+    if (!InstallRecordStore::GetInstance().IsCreated()) {
         InstallAllSystemBundle(SYSTEM_APP_FLAG);
         InstallAllSystemBundle(THIRD_SYSTEM_APP_FLAG);
         return;
     }
 
-    // get third system bundle uninstall record
-    cJSON *uninstallRecord = BundleUtil::GetJsonStream(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON);
-    if (uninstallRecord == nullptr) {
-        BundleDaemonClient::GetInstance().RemoveFile(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON);
+    // system apps, third system apps, third apps and third apps in sdcard, in this order
+    std::vector<BootScanItem> items;
+    ListBootScanItems(SYSTEM_BUNDLE_PATH, SYSTEM_APP_FLAG, items);
+    ListBootScanItems(THIRD_SYSTEM_BUNDLE_PATH, THIRD_SYSTEM_APP_FLAG, items);
+    ListBootScanItems(INSTALL_PATH, THIRD_APP_FLAG, items);
+    if (BundleUtil::IsDir(EXTEANAL_INSTALL_PATH)) {
+        ListBootScanItems(EXTEANAL_INSTALL_PATH, THIRD_APP_FLAG, items);
+    }
+    BundleRegistrySnapshot &snapshot = BundleRegistrySnapshot::GetInstance();
+    (void) snapshot.Load();
+    BootScanContext context = { &items };
+    // the haps and the install records are read by several threads, nothing is changed meanwhile
+    BundleScanPool checkPool(CheckBootScanTask, &context);
+    checkPool.Run(static_cast<uint32_t>(items.size()));
+    // the first item of a bundle wins, e.g. a system app over its code path in INSTALL_PATH
+    std::set<std::string> bundleNames;
+    for (auto &item : items) {
+        if (item.action != BOOT_SCAN_SKIP && !bundleNames.insert(item.bundleName).second) {
+            item.action = BOOT_SCAN_SKIP;
+        }
     }
-
-    // scan system apps
-    ScanAppDir(SYSTEM_BUNDLE_PATH, nullptr, SYSTEM_APP_FLAG);
-    // scan third system apps
-    ScanAppDir(THIRD_SYSTEM_BUNDLE_PATH, uninstallRecord, THIRD_SYSTEM_APP_FLAG);
-    if (uninstallRecord != nullptr) {
-        cJSON_Delete(uninstallRecord);
-        uninstallRecord = nullptr;
+    // BundleInfoCreator only fills in the bundle info it returns, the resource lookups it makes are serialized by
+    // BundleResTransform, so the profiles of different items are parsed in parallel
+    BundleScanPool parsePool(ParseBootScanTask, &context);
+    parsePool.Run(static_cast<uint32_t>(items.size()));
+    // the registry and the uid maps are only changed here, in the order of the items
+    for (auto &item : items) {
+        ApplyBootScanItem(item);
     }
-    // scan third apps
-    ScanAppDir(INSTALL_PATH, nullptr, THIRD_APP_FLAG);
-    // scan third apps in sdcard if exists
-    if (BundleUtil::IsDir(EXTEANAL_INSTALL_PATH)) {
-        ScanAppDir(EXTEANAL_INSTALL_PATH, nullptr, THIRD_APP_FLAG);
+    snapshot.Release();
+    (void) snapshot.Save(*bundleMap_);
+}
+
+void ManagerService::ListBootScanItems(const char *appDir, uint8_t scanFlag, std::vector<BootScanItem> &items)
+{
+    std::vector<std::string> names;
+    ListDirEntries(appDir, names);
+    for (const auto &name : names) {
+        BootScanItem item;
+        item.appPath = std::string(appDir) + PATH_SEPARATOR + name;
+        item.scanFlag = scanFlag;
+        // the directory of a third app is named after its bundle
+        if (scanFlag == THIRD_APP_FLAG) {
+            item.bundleName = name;
+        }
+        items.push_back(std::move(item));
     }
 }
 
-void ManagerService::ScanAppDir(const char *appDir, const cJSON *uninstallRecord, uint8_t scanFlag)
+void ManagerService::CheckBootScanTask(void *context, uint32_t index)
 {
-    dirent *ent = nullptr;
-    char *bundleName = nullptr;
-    int32_t versionCode = -1;
+    CheckBootScanItem((*static_cast<BootScanContext *>(context)->items)[index]);
+}
 
-    if (appDir == nullptr) {
+void ManagerService::ParseBootScanTask(void *context, uint32_t index)
+{
+    BootScanItem &item = (*static_cast<BootScanContext *>(context)->items)[index];
+    // an item restored from the registry snapshot is parsed already
+    if ((item.action != BOOT_SCAN_RELOAD && item.action != BOOT_SCAN_RELOAD_AND_INSTALL) ||
+        !item.bundleInfos.empty()) {
         return;
     }
+    if (!LAZY_REGISTRY || !CreateBootScanStub(item)) {
+        ParseBootScanProfiles(item);
+    }
+}
 
-    DIR *dir = opendir(appDir);
-    if (dir == nullptr) {
+void ManagerService::CheckBootScanItem(BootScanItem &item)
+{
+    int32_t versionCode = -1;
+    if (item.scanFlag == THIRD_APP_FLAG) {
+        if (!BundleUtil::IsDir(item.appPath.c_str())) {
+            return;
+        }
+    } else if (!CheckSystemBootScanHap(item, versionCode)) {
         return;
     }
-    while ((ent = readdir(dir)) != nullptr) {
-        if ((strcmp(ent->d_name, ".") == 0) || (strcmp(ent->d_name, "..")) == 0) {
-            continue;
-        }
-        std::string appPath = std::string(appDir) + PATH_SEPARATOR + ent->d_name;
-        if (scanFlag == THIRD_APP_FLAG) {
-            if (!BundleUtil::IsDir(appPath.c_str())) {
-                continue;
-            }
-            ReloadEntireBundleInfo(appPath.c_str(), ent->d_name, versionCode, scanFlag);
-            continue;
-        }
 
-        // scan system app
-        bool res = CheckSystemBundleIsValid(appPath.c_str(), &bundleName, versionCode);
+    int32_t oldVersionCode = -1;
+    bool res = false;
+    // a stub is cheaper than a bundle info from the snapshot, which has everything the stub would defer
+    BundleInfo *bundleInfo = LAZY_REGISTRY ? nullptr :
+        BundleRegistrySnapshot::GetInstance().GetBundleInfo(item.bundleName);
+    if (bundleInfo != nullptr && bundleInfo->codePath != nullptr && bundleInfo->appId != nullptr &&
+        BundleUtil::IsDir(bundleInfo->codePath)) {
+        // the install record did not change since the snapshot, nor did the profiles installed with it
+        item.codePath = bundleInfo->codePath;
+        item.appId = bundleInfo->appId;
+        oldVersionCode = bundleInfo->versionCode;
+        bundleInfo->isSystemApp = (item.scanFlag == SYSTEM_APP_FLAG);
+        item.bundleInfos.push_back(bundleInfo);
+        res = true;
+    } else {
+        BundleInfoUtils::FreeBundleInfo(bundleInfo);
+        StoredRecord record;
+        res = InstallRecordStore::GetInstance().CheckRecordIsValid(item.bundleName, record);
+        if (res) {
+            item.codePath = std::move(record.codePath);
+            item.appId = std::move(record.appId);
+            oldVersionCode = record.versionCode;
+            item.uid = record.uid;
+        }
+    }
+    item.recordVersionCode = oldVersionCode;
+    if (item.scanFlag != THIRD_APP_FLAG) {
         if (!res) {
-            AdapterFree(bundleName);
-            continue;
+            item.action = BOOT_SCAN_INSTALL;
+        } else {
+            item.action = (versionCode > oldVersionCode) ? BOOT_SCAN_RELOAD_AND_INSTALL : BOOT_SCAN_RELOAD;
         }
+        return;
+    }
+    if (!res) {
+        HILOG_ERROR(HILOG_MODULE_APP, "codePath or appid in third app json file is invalid!");
+        return;
+    }
+    item.action = BOOT_SCAN_RELOAD;
+}
 
-        if (scanFlag == THIRD_SYSTEM_APP_FLAG &&
-            CheckThirdSystemBundleHasUninstalled(bundleName, uninstallRecord)) {
-            AdapterFree(bundleName);
-            continue;
+bool ManagerService::CheckSystemBootScanHap(BootScanItem &item, int32_t &versionCode)
+{
+    BundleRegistrySnapshot &snapshot = BundleRegistrySnapshot::GetInstance();
+    FileStamp stamp;
+    bool hasStamp = BundleRegistrySnapshot::GetFileStamp(item.appPath, stamp);
+    std::string bundleName;
+    // an unchanged hap is not unzipped again
+    if (!hasStamp || !snapshot.GetHap(item.appPath, stamp, bundleName, versionCode)) {
+        char *name = nullptr;
+        if (!CheckSystemBundleIsValid(item.appPath.c_str(), &name, versionCode)) {
+            AdapterFree(name);
+            return false;
         }
-        ReloadEntireBundleInfo(appPath.c_str(), bundleName, versionCode, scanFlag);
-        AdapterFree(bundleName);
+        bundleName = name;
+        AdapterFree(name);
     }
-    closedir(dir);
+    if (hasStamp) {
+        snapshot.SetHap(item.appPath, stamp, bundleName, versionCode);
+    }
+    if (item.scanFlag == THIRD_SYSTEM_APP_FLAG &&
+        InstallRecordStore::GetInstance().IsUninstalledThirdSystemBundle(bundleName)) {
+        return false;
+    }
+    item.bundleName = bundleName;
+    return true;
 }
 
-bool ManagerService::CheckSystemBundleIsValid(const char *appPath, char **bundleName, int32_t &versionCode)
+void ManagerService::ParseBootScanProfiles(BootScanItem &item)
 {
-    if (appPath == nullptr || bundleName == nullptr) {
-        return false;
+    int32_t uid = item.uid;
+    int32_t gid = uid;
+    if (uid == INVALID_UID || gid == INVALID_GID) {
+        HILOG_ERROR(HILOG_MODULE_APP, "get uid or gid in install record fail!");
+        return;
     }
 
-    if (!BundleUtil::EndWith(appPath, INSTALL_FILE_SUFFIX)) {
-        return false;
+    std::vector<std::string> names;
+    ListDirEntries(item.codePath.c_str(), names);
+    BundleParser bundleParser;
+    for (const auto &name : names) {
+        std::string profileDir = item.codePath + PATH_SEPARATOR + name;
+        BundleInfo *bundleInfo = bundleParser.ParseHapProfile(profileDir.c_str());
+        if (bundleInfo == nullptr) {
+            item.invalidProfileDirs.push_back(profileDir);
+            continue;
+        }
+        bundleInfo->isSystemApp = (item.scanFlag == SYSTEM_APP_FLAG);
+        bundleInfo->appId = Utils::Strdup(item.appId.c_str());
+        if (bundleInfo->appId == nullptr) {
+            HILOG_ERROR(HILOG_MODULE_APP, "bundleInfo->appId is nullptr when restore bundleInfo!");
+            BundleInfoUtils::FreeBundleInfo(bundleInfo);
+            continue;
+        }
+        bundleInfo->uid = static_cast<int32_t>(uid);
+        bundleInfo->gid = static_cast<int32_t>(gid);
+        item.bundleInfos.push_back(bundleInfo);
     }
+}
 
-    if (BundleParser::ParseBundleParam(appPath, bundleName, versionCode) != 0) {
+bool ManagerService::CreateBootScanStub(BootScanItem &item)
+{
+    int32_t uid = item.uid;
+    std::vector<std::string> names;
+    ListDirEntries(item.codePath.c_str(), names);
+    bool isKeepAlive = false;
+    // the profile parsed first is the one registered, see ParseBootScanProfiles
+    if (uid == INVALID_UID || names.empty() ||
+        !BundleParser::ParseKeepAlive((item.codePath + PATH_SEPARATOR + names[0]).c_str(), isKeepAlive)) {
         return false;
     }
-
-    if (*bundleName != nullptr && strlen(*bundleName) > MAX_BUNDLE_NAME_LEN) {
+    BundleInfo *stub = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo)));
+    if (stub == nullptr || memset_s(stub, sizeof(BundleInfo), 0, sizeof(BundleInfo)) != EOK) {
+        AdapterFree(stub);
+        return false;
+    }
+    stub->bundleName = Utils::Strdup(item.bundleName.c_str());
+    stub->codePath = Utils::Strdup(item.codePath.c_str());
+    stub->appId = Utils::Strdup(item.appId.c_str());
+    if (stub->bundleName == nullptr || stub->codePath == nullptr || stub->appId == nullptr) {
+        BundleInfoUtils::FreeBundleInfo(stub);
         return false;
     }
+    stub->versionCode = item.recordVersionCode;
+    stub->uid = uid;
+    stub->gid = uid;
+    stub->isSystemApp = (item.scanFlag == SYSTEM_APP_FLAG);
+    stub->isKeepAlive = isKeepAlive;
+    item.bundleInfos.push_back(stub);
+    item.isStub = true;
     return true;
 }
 
-void ManagerService::ReloadEntireBundleInfo(const char *appPath, const char *bundleName, int32_t versionCode,
-    uint8_t scanFlag)
+BundleInfo *ManagerService::LoadBundleInfo(const BundleInfo &stub)
 {
-    char *codePath = nullptr;
-    char *appId = nullptr;
-    int32_t oldVersionCode = -1;
-    InstallParam installParam = {.installLocation = 1, .keepData = false};
-
-    if (appPath == nullptr || bundleName == nullptr || installer_ == nullptr) {
-        return;
-    }
-
-    if (QueryBundleInfo(bundleName) != nullptr) {
-        return;
+    if (stub.bundleName == nullptr || stub.codePath == nullptr || stub.appId == nullptr) {
+        return nullptr;
     }
-
-    bool res = BundleUtil::CheckBundleJsonIsValid(bundleName, &codePath, &appId, oldVersionCode);
-    bool isSystemApp = (scanFlag == SYSTEM_APP_FLAG);
-    if (scanFlag != THIRD_APP_FLAG) {
-        if (!res) {
-            uint8_t ret = installer_->Install(appPath, installParam);
-            HILOG_INFO(HILOG_MODULE_APP, "install new system app, result is %d", ret);
-            AdapterFree(codePath);
-            AdapterFree(appId);
-            return;
-        }
-        if (versionCode > oldVersionCode) {
-            ReloadBundleInfo(codePath, appId, bundleName, isSystemApp);
-            uint8_t ret = installer_->Install(appPath, installParam);
-            HILOG_INFO(HILOG_MODULE_APP, "update system app, result is %d", ret);
-            AdapterFree(codePath);
-            AdapterFree(appId);
-            return;
+    std::vector<std::string> names;
+    ListDirEntries(stub.codePath, names);
+    BundleParser bundleParser;
+    for (const auto &name : names) {
+        std::string profileDir = std::string(stub.codePath) + PATH_SEPARATOR + name;
+        BundleInfo *bundleInfo = bundleParser.ParseHapProfile(profileDir.c_str());
+        if (bundleInfo == nullptr) {
+            continue;
         }
-    } else {
-        if (!res) {
-            HILOG_ERROR(HILOG_MODULE_APP, "codePath or appid in third app json file is invalid!");
-            AdapterFree(codePath);
-            AdapterFree(appId);
-            return;
+        bundleInfo->isSystemApp = stub.isSystemApp;
+        bundleInfo->appId = Utils::Strdup(stub.appId);
+        if (bundleInfo->appId == nullptr || bundleInfo->bundleName == nullptr ||
+            strcmp(bundleInfo->bundleName, stub.bundleName) != 0) {
+            BundleInfoUtils::FreeBundleInfo(bundleInfo);
+            continue;
         }
+        bundleInfo->uid = stub.uid;
+        bundleInfo->gid = stub.gid;
+        return bundleInfo;
     }
-    ReloadBundleInfo(codePath, appId, bundleName, isSystemApp);
-    AdapterFree(appId);
-    AdapterFree(codePath);
+    return nullptr;
 }
 
-void ManagerService::ReloadBundleInfo(const char *codePath, const char *appId, const char *bundleName,
-    bool isSystemApp)
+void ManagerService::ApplyBootScanItem(BootScanItem &item)
 {
-    BundleParser bundleParser;
-    dirent *ent = nullptr;
-
-    int32_t uid = BundleUtil::GetValueFromBundleJson(bundleName, JSON_SUB_KEY_UID, INVALID_UID);
-    int32_t gid = uid;
-    if (uid == INVALID_UID || gid == INVALID_GID) {
-        HILOG_ERROR(HILOG_MODULE_APP, "get uid or gid in json file fail!");
-        return;
-    }
-
-    DIR *dir = opendir(codePath);
-    if (dir == nullptr) {
+    if (item.action == BOOT_SCAN_SKIP || installer_ == nullptr ||
+        QueryBundleInfo(item.bundleName.c_str()) != nullptr) {
+        for (BundleInfo *bundleInfo : item.bundleInfos) {
+            BundleInfoUtils::FreeBundleInfo(bundleInfo);
+        }
+        item.bundleInfos.clear();
         return;
     }
-
-    while ((ent = readdir(dir)) != nullptr) {
-        if ((strcmp(ent->d_name, ".") == 0) || (strcmp(ent->d_name, "..")) == 0) {
-            continue;
-        }
-        std::string profileDir = codePath + std::string(PATH_SEPARATOR) + ent->d_name;
-        BundleInfo *bundleInfo = bundleParser.ParseHapProfile(profileDir.c_str());
-        if (bundleInfo != nullptr) {
-            bundleInfo->isSystemApp = isSystemApp;
-            bundleInfo->appId = Utils::Strdup(appId);
-            if (bundleInfo->appId == nullptr) {
-                HILOG_ERROR(HILOG_MODULE_APP, "bundleInfo->appId is nullptr when restore bundleInfo!");
-                BundleInfoUtils::FreeBundleInfo(bundleInfo);
-                continue;
-            }
-            bundleInfo->uid = static_cast<int32_t>(uid);
-            bundleInfo->gid = static_cast<int32_t>(gid);
-            // need to update bundleInfo when support many haps install
-            bundleMap_->Add(bundleInfo);
+    for (BundleInfo *bundleInfo : item.bundleInfos) {
+        // need to update bundleInfo when support many haps install
+        if (item.isStub) {
+            bundleMap_->AddStub(bundleInfo);
         } else {
-            BundleDaemonClient::GetInstance().RemoveFile(profileDir.c_str());
-            // delete uid and gid info
-            BundleUtil::DeleteUidInfoFromJson(bundleName);
+            bundleMap_->Add(bundleInfo);
         }
     }
-    closedir(dir);
+    item.bundleInfos.clear();
+    for (const auto &profileDir : item.invalidProfileDirs) {
+        BundleDaemonClient::GetInstance().RemoveFile(profileDir.c_str());
+    }
+    if (!item.invalidProfileDirs.empty()) {
+        // delete uid and gid info
+        InstallRecordBatch batch;
+        batch.ReleaseUid(item.bundleName);
+        (void) InstallRecordStore::GetInstance().Apply(batch);
+    }
+    if (item.action == BOOT_SCAN_RELOAD) {
+        return;
+    }
+    InstallParam installParam = {.installLocation = 1, .keepData = false};
+    uint8_t ret = installer_->Install(item.appPath.c_str(), installParam);
+    HILOG_INFO(HILOG_MODULE_APP, "%{public}s system app, result is %{public}d",
+        (item.action == BOOT_SCAN_INSTALL) ? "install new" : "update", ret);
 }
 
-bool ManagerService::CheckThirdSystemBundleHasUninstalled(const char *bundleName, const cJSON *object)
+bool ManagerService::CheckSystemBundleIsValid(const char *appPath, char **bundleName, int32_t &versionCode)
 {
-    if (object == nullptr || bundleName == nullptr) {
+    if (appPath == nullptr || bundleName == nullptr) {
         return false;
     }
 
-    cJSON *array = cJSON_GetObjectItem(object, JSON_MAIN_KEY);
-    if (!cJSON_IsArray(array)) {
+    if (!BundleUtil::EndWith(appPath, INSTALL_FILE_SUFFIX)) {
         return false;
     }
 
-    cJSON *item = nullptr;
-    cJSON_ArrayForEach(item, array) {
-        if (!cJSON_IsString(item)) {
-            return false;
-        }
-        if ((item->valuestring != nullptr) && strcmp(bundleName, item->valuestring) == 0) {
-            return true;
-        }
+    if (BundleParser::ParseBundleParam(appPath, bundleName, versionCode) != 0) {
+        return false;
     }
-    return false;
+
+    if (*bundleName != nullptr && strlen(*bundleName) > MAX_BUNDLE_NAME_LEN) {
+        return false;
+    }
+    return true;
 }
 
 BundleInfo *ManagerService::QueryBundleInfo(const char *bundleName)
@@ -625,6 +1068,20 @@ uint8_t ManagerService::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos,
     return bundleMap_->GetBundleInfos(flags, bundleInfos, len);
 }
 
+static bool IsKeepAliveSystemBundle(const BundleInfo &bundleInfo)
+{
+    return bundleInfo.isKeepAlive && bundleInfo.isSystemApp;
+}
+
+uint8_t ManagerService::GetKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len)
+{
+    if (bundleMap_ == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    // other bundles are not loaded for it
+    return bundleMap_->GetBundleInfos(1, bundleInfos, len, IsKeepAliveSystemBundle);
+}
+
 uint32_t ManagerService::GetBundleSize(const char *bundleName)
 {
     if (bundleName == nullptr) {
@@ -645,24 +1102,6 @@ uint32_t ManagerService::GetBundleSize(const char *bundleName)
     return codeBundleSize + dataBundleSize;
 }
 
-std::string ManagerService::GetCodeDirPath() const
-{
-    std::string codeDirPath;
-    if (installer_ == nullptr) {
-        return codeDirPath;
-    }
-    return installer_->GetCodeDirPath();
-}
-
-std::string ManagerService::GetDataDirPath() const
-{
-    std::string dataDirPath;
-    if (installer_ == nullptr) {
-        return dataDirPath;
-    }
-    return installer_->GetDataDirPath();
-}
-
 static int32_t GenerateInnerUid(std::map<int, std::string> &innerMap, const std::string &bundleName,
     int8_t bundleStyle, int32_t baseUid)
 {
@@ -697,15 +1136,17 @@ int32_t ManagerService::GenerateUid(const char *bundleName, int8_t bundleStyle)
         return INVALID_UID;
     }
 
+    int32_t uid = INVALID_UID;
+    pthread_mutex_lock(&uidMutex_);
     if (bundleStyle == THIRD_SYSTEM_APP_FLAG) {
-        return GenerateInnerUid(sysVendorUidMap_, bundleName, THIRD_SYSTEM_APP_FLAG, BASE_SYS_VEN_UID);
+        uid = GenerateInnerUid(sysVendorUidMap_, bundleName, THIRD_SYSTEM_APP_FLAG, BASE_SYS_VEN_UID);
     } else if (bundleStyle == THIRD_APP_FLAG) {
-        return GenerateInnerUid(appUidMap_, bundleName, THIRD_APP_FLAG, BASE_APP_UID);
+        uid = GenerateInnerUid(appUidMap_, bundleName, THIRD_APP_FLAG, BASE_APP_UID);
     } else if (bundleStyle == SYSTEM_APP_FLAG) {
-        return GenerateInnerUid(sysUidMap_, bundleName, SYSTEM_APP_FLAG, BASE_SYS_UID);
-    } else {
-        return INVALID_UID;
+        uid = GenerateInnerUid(sysUidMap_, bundleName, SYSTEM_APP_FLAG, BASE_SYS_UID);
     }
+    pthread_mutex_unlock(&uidMutex_);
+    return uid;
 }
 
 bool ManagerService::RecycleInnerUid(const std::string &bundleName, std::map<int, std::string> &innerMap)
@@ -727,31 +1168,41 @@ void ManagerService::RecycleUid(const char *bundleName)
         return;
     }
 
-    if (RecycleInnerUid(bundleName, appUidMap_) || RecycleInnerUid(bundleName, sysVendorUidMap_) ||
-        RecycleInnerUid(bundleName, sysUidMap_)) {
-        return;
+    pthread_mutex_lock(&uidMutex_);
+    if (!RecycleInnerUid(bundleName, appUidMap_) && !RecycleInnerUid(bundleName, sysVendorUidMap_)) {
+        (void) RecycleInnerUid(bundleName, sysUidMap_);
     }
+    pthread_mutex_unlock(&uidMutex_);
 }
 
-void ManagerService::ScanSharedLibPath()
+static void CollectSystemCodePath(const BundleInfo *bundleInfo, bool isStub, void *context)
 {
-    BundleInfo *bundleInfos = nullptr;
-    int32_t len = 0;
-    if (bundleMap_->GetBundleInfos(1, &bundleInfos, &len) != ERR_OK) {
-        HILOG_ERROR(HILOG_MODULE_APP, "ScanSharedLibPath GetBundleInfos is error");
+    if (!bundleInfo->isSystemApp || bundleInfo->codePath == nullptr) {
         return;
     }
-    if (bundleInfos == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "ScanSharedLibPath bundleInfos is unavailable");
-        return;
+    // the module of a stub is found on disk, without loading the bundle
+    std::string moduleName;
+    if (!isStub && bundleInfo->moduleInfos != nullptr && bundleInfo->moduleInfos[0].moduleName != nullptr) {
+        moduleName = bundleInfo->moduleInfos[0].moduleName;
     }
-    for (int32_t index = 0; index < len; ++index) {
-        if (!(bundleInfos + index)->isSystemApp) {
-            continue;
+    static_cast<std::vector<std::pair<std::string, std::string>> *>(context)->emplace_back(bundleInfo->codePath,
+        moduleName);
+}
+
+void ManagerService::ScanSharedLibPath()
+{
+    std::vector<std::pair<std::string, std::string>> modules;
+    bundleMap_->ForEach(CollectSystemCodePath, &modules);
+    for (auto &module : modules) {
+        if (module.second.empty()) {
+            std::vector<std::string> names;
+            ListDirEntries(module.first.c_str(), names);
+            if (names.empty()) {
+                continue;
+            }
+            module.second = names[0];
         }
-        std::string path = (bundleInfos + index)->codePath;
-        path = path + PATH_SEPARATOR + (bundleInfos + index)->moduleInfos[0].moduleName + PATH_SEPARATOR +
-               SHARED_LIB_NAME;
+        std::string path = module.first + PATH_SEPARATOR + module.second + PATH_SEPARATOR + SHARED_LIB_NAME;
         if (!BundleUtil::IsDir(path.c_str())) {
             continue;
         }
@@ -760,41 +1211,23 @@ void ManagerService::ScanSharedLibPath()
             HILOG_WARN(HILOG_MODULE_APP, "ScanSharedLibPath move file to share library failed");
         }
     }
-    BundleInfoUtils::FreeBundleInfos(bundleInfos, len);
 }
 
 void ManagerService::RestoreUidAndGidMap()
 {
-    std::string uidJsonPath = std::string(JSON_PATH) + UID_GID_MAP + JSON_SUFFIX;
-    cJSON *object = BundleUtil::GetJsonStream(uidJsonPath.c_str());
-    if (object == nullptr) {
-        return;
-    }
-
-    cJSON *uids = cJSON_GetObjectItemCaseSensitive(object, "uid_and_gid");
-    if (!(cJSON_IsArray(uids))) {
-        cJSON_Delete(object);
-        return;
-    }
-    cJSON *uid = nullptr;
-    cJSON_ArrayForEach(uid, uids) {
-        cJSON *innerUid = cJSON_GetObjectItemCaseSensitive(uid, JSON_SUB_KEY_UID);
-        cJSON *innerBundleName = cJSON_GetObjectItemCaseSensitive(uid, JSON_SUB_KEY_PACKAGE);
-        if ((!cJSON_IsNumber(innerUid)) || (!cJSON_IsString(innerBundleName))) {
-            continue;
-        }
-        uint32_t uidValue = innerUid->valueint;
+    std::map<std::string, int32_t> uids;
+    InstallRecordStore::GetInstance().GetUids(uids);
+    for (const auto &it : uids) {
+        uint32_t uidValue = it.second;
         if ((uidValue < BASE_SYS_VEN_UID) && (uidValue >= BASE_SYS_UID)) {
-            sysUidMap_[uidValue - BASE_SYS_UID] = innerBundleName->valuestring;
+            sysUidMap_[uidValue - BASE_SYS_UID] = it.first;
         } else if ((uidValue >= BASE_SYS_VEN_UID) && (uidValue <= MAX_SYS_VEN_UID)) {
-            sysVendorUidMap_[uidValue - BASE_SYS_VEN_UID] = innerBundleName->valuestring;
+            sysVendorUidMap_[uidValue - BASE_SYS_VEN_UID] = it.first;
         } else if (uidValue > MAX_SYS_VEN_UID) {
-            appUidMap_[uidValue - BASE_APP_UID] = innerBundleName->valuestring;
+            appUidMap_[uidValue - BASE_APP_UID] = it.first;
         } else {
             continue;
         }
     }
-    cJSON_Delete(object);
-    return;
 }
 } // namespace OHOS
@@ -23,6 +23,9 @@
 #include "adapter.h"
 #include "appexecfwk_errors.h"
 #include "bundle_info_utils.h"
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+#include "log.h"
+#endif
 #include "utils.h"
 
 namespace OHOS {
@@ -96,6 +99,9 @@ bool BundleMap::Update(BundleInfo *bundleInfo)
             oldNode->next_->prev_ = newNode;
             newNode->prev_ = oldNode->prev_;
             newNode->next_ = oldNode->next_;
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+            stubs_.erase(info);
+#endif
             BundleInfoUtils::FreeBundleInfo(info);
             delete oldNode;
             MutexRelease(&g_bundleListMutex);
@@ -122,6 +128,9 @@ BundleInfo *BundleMap::Get(const char *bundleName) const
     for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
         BundleInfo *info = node->value_;
         if (info != nullptr && info->bundleName != nullptr && strcmp(info->bundleName, bundleName) == 0) {
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+            info = LoadStub(node);
+#endif
             MutexRelease(&g_bundleListMutex);
             return info;
         }
@@ -171,24 +180,30 @@ void BundleMap::GetCopyBundleInfo(uint32_t flags, const BundleInfo *bundleInfo,
 #endif
 }
 
-uint8_t BundleMap::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len) const
+uint8_t BundleMap::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len, Filter filter) const
 {
     if (bundleInfos == nullptr) {
         return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
     }
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
     MutexAcquire(&g_bundleListMutex, 0);
+    LoadStubs(filter);
 #else
     MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
 #endif
-    if (bundleInfos_->IsEmpty()) {
+    uint32_t num = 0;
+    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
+        if (filter == nullptr || filter(*(node->value_))) {
+            num++;
+        }
+    }
+    if (num == 0) {
         MutexRelease(&g_bundleListMutex);
         return ERR_APPEXECFWK_QUERY_NO_INFOS;
     }
 
-    BundleInfo *infos = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo) * bundleInfos_->Size()));
-    if (infos == nullptr || memset_s(infos, sizeof(BundleInfo) * bundleInfos_->Size(), 0,
-        sizeof(BundleInfo) * bundleInfos_->Size()) != EOK) {
+    BundleInfo *infos = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo) * num));
+    if (infos == nullptr || memset_s(infos, sizeof(BundleInfo) * num, 0, sizeof(BundleInfo) * num) != EOK) {
         AdapterFree(infos);
         MutexRelease(&g_bundleListMutex);
         return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
@@ -196,10 +211,12 @@ uint8_t BundleMap::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32
     *bundleInfos = infos;
 
     for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfoUtils::CopyBundleInfo(flags, infos++, *(node->value_));
+        if (filter == nullptr || filter(*(node->value_))) {
+            BundleInfoUtils::CopyBundleInfo(flags, infos++, *(node->value_));
+        }
     }
 
-    *len = bundleInfos_->Size();
+    *len = static_cast<int32_t>(num);
     MutexRelease(&g_bundleListMutex);
     return ERR_OK;
 }
@@ -211,6 +228,7 @@ uint8_t BundleMap::GetBundleInfosNoReplication(int32_t flags, BundleInfo **bundl
     }
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
     MutexAcquire(&g_bundleListMutex, 0);
+    LoadStubs(nullptr);
 #else
     MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
 #endif
@@ -265,6 +283,9 @@ void BundleMap::Erase(const char *bundleName)
     for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
         BundleInfo *info = node->value_;
         if (info->bundleName != nullptr && strcmp(info->bundleName, bundleName) == 0) {
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+            stubs_.erase(info);
+#endif
             BundleInfoUtils::FreeBundleInfo(info);
             bundleInfos_->Remove(node);
             MutexRelease(&g_bundleListMutex);
@@ -285,6 +306,93 @@ void BundleMap::EraseAll()
         BundleInfoUtils::FreeBundleInfo(node->value_);
     }
     bundleInfos_->RemoveAll();
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    stubs_.clear();
+#endif
+    MutexRelease(&g_bundleListMutex);
+}
+
+void BundleMap::ForEach(Visitor visitor, void *context) const
+{
+    if (visitor == nullptr) {
+        return;
+    }
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    MutexAcquire(&g_bundleListMutex, 0);
+#else
+    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
+#endif
+    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
+        if (node->value_ == nullptr) {
+            continue;
+        }
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+        visitor(node->value_, stubs_.count(node->value_) != 0, context);
+#else
+        visitor(node->value_, false, context);
+#endif
+    }
+    MutexRelease(&g_bundleListMutex);
+}
+
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+void BundleMap::AddStub(BundleInfo *stub)
+{
+    if ((stub == nullptr) || (stub->bundleName == nullptr)) {
+        return;
+    }
+    MutexAcquire(&g_bundleListMutex, 0);
+    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
+        BundleInfo *info = node->value_;
+        if (info != nullptr && info->bundleName != nullptr && strcmp(info->bundleName, stub->bundleName) == 0) {
+            MutexRelease(&g_bundleListMutex);
+            return;
+        }
+    }
+    bundleInfos_->PushFront(stub);
+    stubs_.insert(stub);
     MutexRelease(&g_bundleListMutex);
 }
+
+void BundleMap::SetLoader(Loader loader)
+{
+    MutexAcquire(&g_bundleListMutex, 0);
+    loader_ = loader;
+    MutexRelease(&g_bundleListMutex);
+}
+
+// runs with the list locked, node is removed when its stub cannot be loaded
+BundleInfo *BundleMap::LoadStub(Node<BundleInfo *> *node) const
+{
+    BundleInfo *stub = node->value_;
+    if (stubs_.erase(stub) == 0) {
+        return stub;
+    }
+    BundleInfo *bundleInfo = (loader_ == nullptr) ? nullptr : loader_(*stub);
+    if (bundleInfo == nullptr) {
+        // like a bundle whose profile is broken at boot, it is left out of the registry
+        HILOG_ERROR(HILOG_MODULE_APP, "load bundle info of %{public}s fail!", stub->bundleName);
+        bundleInfos_->Remove(node);
+    } else {
+        node->value_ = bundleInfo;
+    }
+    BundleInfoUtils::FreeBundleInfo(stub);
+    return bundleInfo;
+}
+
+void BundleMap::LoadStubs(Filter filter) const
+{
+    if (stubs_.empty()) {
+        return;
+    }
+    auto node = bundleInfos_->Begin();
+    while (node != bundleInfos_->End()) {
+        auto next = node->next_;
+        if (filter == nullptr || filter(*(node->value_))) {
+            (void) LoadStub(node);
+        }
+        node = next;
+    }
+}
+#endif
 }  // namespace OHOS
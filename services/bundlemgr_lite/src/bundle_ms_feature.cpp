@@ -442,39 +442,8 @@ uint8_t BundleMsFeature::QueryKeepAliveBundleInfos(BundleInfo **bundleInfos, int
     if ((bundleInfos == nullptr) || (len == nullptr)) {
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
-    BundleInfo *allBundleInfos = nullptr;
-    int32_t numOfAllBundleInfos = 0;
-    uint8_t errorCode = GetBundleInfos(1, &allBundleInfos, &numOfAllBundleInfos);
-    if (errorCode != OHOS_SUCCESS) {
-        return errorCode;
-    }
     *len = 0;
-    for (int32_t i = 0; i < numOfAllBundleInfos; i++) {
-        if (allBundleInfos[i].isKeepAlive && allBundleInfos[i].isSystemApp) {
-            (*len)++;
-        }
-    }
-
-    if (*len == 0) {
-        BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-        return ERR_APPEXECFWK_QUERY_NO_INFOS;
-    }
-    *bundleInfos = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo) * (*len)));
-    if (*bundleInfos == nullptr || memset_s(*bundleInfos, sizeof(BundleInfo) * (*len), 0,
-        sizeof(BundleInfo) * (*len)) != EOK) {
-        BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
-    }
-
-    int32_t count = 0;
-    for (int32_t i = 0; i < numOfAllBundleInfos && count < *len; i++) {
-        if (allBundleInfos[i].isKeepAlive && allBundleInfos[i].isSystemApp) {
-            OHOS::BundleInfoUtils::CopyBundleInfo(1, *bundleInfos + count, allBundleInfos[i]);
-            count++;
-        }
-    }
-    BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-    return OHOS_SUCCESS;
+    return OHOS::ManagerService::GetInstance().GetKeepAliveBundleInfos(bundleInfos, len);
 }
 
 static bool CheckBundleInfoWithSpecialMetaData(const BundleInfo &bundleInfo, const char *metaDataKey)
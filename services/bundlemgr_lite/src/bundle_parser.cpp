@@ -187,11 +187,11 @@ int8_t BundleParser::ParseBundleParam(const char *path, char **bundleName, int32
     if (!BundleUtil::IsFile(path)) {
         return ERR_APPEXECFWK_INSTALL_FAILED_FILE_NOT_EXISTS;
     }
-    std::ostringstream profileStream;
-    if (BundleExtractor::ExtractHapProfile(path, profileStream) != ERR_OK) {
+    std::unique_ptr<char[]> profile;
+    if (BundleExtractor::ExtractHapProfile(path, profile) != ERR_OK) {
         return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
     }
-    cJSON *root = cJSON_Parse(profileStream.str().c_str());
+    cJSON *root = cJSON_Parse(profile.get());
     if (root == nullptr) {
         return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
     }
@@ -275,14 +275,40 @@ BundleInfo *BundleParser::ParseHapProfile(const char *path)
     return bundleInfo;
 }
 
-uint8_t BundleParser::ParseHapProfile(const std::string &path, Permissions &permissions, BundleRes &bundleRes,
-    BundleInfo **bundleInfo)
+bool BundleParser::ParseKeepAlive(const char *path, bool &isKeepAlive)
 {
-    std::ostringstream profileStream;
-    uint8_t errorCode = BundleExtractor::ExtractHapProfile(path, profileStream);
+    if (!BundleUtil::CheckRealPath(path)) {
+        return false;
+    }
+
+    std::string profilePath = path + std::string(PATH_SEPARATOR) + PROFILE_NAME;
+    cJSON *root = BundleUtil::GetJsonStream(profilePath.c_str());
+    if (root == nullptr) {
+        return false;
+    }
+
+    BundleProfile bundleProfile;
+    if (memset_s(&bundleProfile, sizeof(BundleProfile), 0, sizeof(BundleProfile)) != EOK) {
+        cJSON_Delete(root);
+        return false;
+    }
+    uint8_t errorCode = ParseDeviceConfig(cJSON_GetObjectItem(root, PROFILE_KEY_DEVICECONFIG), bundleProfile);
+    cJSON_Delete(root);
+    if (errorCode != ERR_OK) {
+        return false;
+    }
+    isKeepAlive = bundleProfile.isKeepAlive;
+    return true;
+}
+
+uint8_t BundleParser::ParseHapProfile(const std::string &path, const std::string &installDirPath,
+    const std::string &dataDirPath, Permissions &permissions, BundleRes &bundleRes, BundleInfo **bundleInfo)
+{
+    std::unique_ptr<char[]> profile;
+    uint8_t errorCode = BundleExtractor::ExtractHapProfile(path, profile);
     CHECK_IS_TRUE((errorCode == ERR_OK), errorCode);
 
-    cJSON *root = cJSON_Parse(profileStream.str().c_str());
+    cJSON *root = cJSON_Parse(profile.get());
     CHECK_IS_TRUE((root != nullptr), ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR);
 
     cJSON *appObject = cJSON_GetObjectItem(root, PROFILE_KEY_APP);
@@ -307,7 +333,7 @@ uint8_t BundleParser::ParseHapProfile(const std::string &path, Permissions &perm
     errorCode = ParsePermissions(object, permissions);
     CHECK_PARSE_RESULT(errorCode, root, bundleProfile);
 
-    errorCode = BundleInfoCreator::SaveBundleInfo(bundleProfile, bundleInfo);
+    errorCode = BundleInfoCreator::SaveBundleInfo(bundleProfile, installDirPath, dataDirPath, bundleInfo);
     CHECK_PARSE_RESULT(errorCode, root, bundleProfile);
 
     FREE_BUNDLE_PROFILE(bundleProfile);
@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_registry_snapshot.h"
+
+#include <sys/stat.h>
+
+#include "adapter.h"
+#include "bundle_common.h"
+#include "bundle_daemon_client.h"
+#include "bundle_info_utils.h"
+#include "global.h"
+#include "install_record_store.h"
+#include "log.h"
+#include "securec.h"
+#include "text_record_codec.h"
+
+namespace OHOS {
+namespace {
+const char SNAPSHOT_MAGIC[] = "BMSR";
+constexpr int64_t SNAPSHOT_FORMAT_VERSION = 2;
+constexpr off_t MAX_SNAPSHOT_FILE_SIZE = 4 * 1024 * 1024;
+constexpr uint8_t MAX_LOCALE_LEN = 16;
+
+struct SaveContext {
+    std::string bundles;
+    int64_t bundleNum = 0;
+};
+}
+
+static void PutStamp(TextRecordWriter &writer, const FileStamp &stamp)
+{
+    writer.PutInt(static_cast<int64_t>(stamp.ino));
+    writer.PutInt(static_cast<int64_t>(stamp.size));
+    writer.PutInt(stamp.mtimeSec);
+    writer.PutInt(stamp.mtimeNsec);
+    writer.PutInt(stamp.ctimeSec);
+    writer.PutInt(stamp.ctimeNsec);
+}
+
+static bool GetStamp(TextRecordReader &reader, FileStamp &stamp)
+{
+    return reader.GetInt(stamp.ino) && reader.GetInt(stamp.size) && reader.GetInt(stamp.mtimeSec) &&
+        reader.GetInt(stamp.mtimeNsec) && reader.GetInt(stamp.ctimeSec) && reader.GetInt(stamp.ctimeNsec);
+}
+
+static void WriteBundleInfo(TextRecordWriter &writer, const BundleInfo &bundleInfo)
+{
+    writer.PutInt(bundleInfo.isKeepAlive);
+    writer.PutInt(bundleInfo.isNativeApp);
+    writer.PutInt(bundleInfo.uid);
+    writer.PutInt(bundleInfo.gid);
+    writer.PutInt(bundleInfo.isSystemApp);
+    writer.PutInt(bundleInfo.compatibleApi);
+    writer.PutInt(bundleInfo.targetApi);
+    writer.PutInt(bundleInfo.versionCode);
+    writer.PutString(bundleInfo.versionName);
+    writer.PutString(bundleInfo.bundleName);
+    writer.PutString(bundleInfo.label);
+    writer.PutString(bundleInfo.bigIconPath);
+    writer.PutString(bundleInfo.codePath);
+    writer.PutString(bundleInfo.dataPath);
+    writer.PutString(bundleInfo.vendor);
+    writer.PutString(bundleInfo.appId);
+    int32_t numOfModule = (bundleInfo.moduleInfos == nullptr) ? 0 : bundleInfo.numOfModule;
+    writer.PutInt(numOfModule);
+    for (int32_t i = 0; i < numOfModule; i++) {
+        const ModuleInfo &moduleInfo = bundleInfo.moduleInfos[i];
+        writer.PutString(moduleInfo.moduleName);
+        writer.PutString(moduleInfo.description);
+        writer.PutString(moduleInfo.name);
+        writer.PutString(moduleInfo.moduleType);
+        writer.PutInt(moduleInfo.isDeliveryInstall);
+        for (uint32_t j = 0; j < DEVICE_TYPE_SIZE; j++) {
+            writer.PutString(moduleInfo.deviceType[j]);
+        }
+        for (uint32_t j = 0; j < METADATA_SIZE; j++) {
+            const MetaData *metaData = moduleInfo.metaData[j];
+            writer.PutInt(metaData != nullptr);
+            if (metaData != nullptr) {
+                writer.PutString(metaData->name);
+                writer.PutString(metaData->value);
+                writer.PutString(metaData->extra);
+            }
+        }
+    }
+    // the device capabilities of an ability are only checked at install, the registry does not keep them
+    int32_t numOfAbility = (bundleInfo.abilityInfos == nullptr) ? 0 : bundleInfo.numOfAbility;
+    writer.PutInt(numOfAbility);
+    for (int32_t i = 0; i < numOfAbility; i++) {
+        const AbilityInfo &abilityInfo = bundleInfo.abilityInfos[i];
+        writer.PutInt(abilityInfo.isVisible);
+        writer.PutInt(abilityInfo.abilityType);
+        writer.PutInt(abilityInfo.launchMode);
+        writer.PutString(abilityInfo.moduleName);
+        writer.PutString(abilityInfo.name);
+        writer.PutString(abilityInfo.description);
+        writer.PutString(abilityInfo.iconPath);
+        writer.PutString(abilityInfo.deviceId);
+        writer.PutString(abilityInfo.label);
+        writer.PutString(abilityInfo.bundleName);
+    }
+}
+
+template<typename T>
+static T *AllocZeroed(int32_t num)
+{
+    if (num <= 0) {
+        return nullptr;
+    }
+    size_t size = sizeof(T) * static_cast<size_t>(num);
+    T *items = reinterpret_cast<T *>(AdapterMalloc(size));
+    if (items != nullptr && memset_s(items, size, 0, size) != EOK) {
+        AdapterFree(items);
+        return nullptr;
+    }
+    return items;
+}
+
+static bool ReadModuleInfo(TextRecordReader &reader, ModuleInfo &moduleInfo)
+{
+    if (!reader.GetString(moduleInfo.moduleName) || !reader.GetString(moduleInfo.description) ||
+        !reader.GetString(moduleInfo.name) || !reader.GetString(moduleInfo.moduleType) ||
+        !reader.GetBool(moduleInfo.isDeliveryInstall)) {
+        return false;
+    }
+    for (uint32_t j = 0; j < DEVICE_TYPE_SIZE; j++) {
+        if (!reader.GetString(moduleInfo.deviceType[j])) {
+            return false;
+        }
+    }
+    for (uint32_t j = 0; j < METADATA_SIZE; j++) {
+        bool hasMetaData = false;
+        if (!reader.GetBool(hasMetaData)) {
+            return false;
+        }
+        if (!hasMetaData) {
+            continue;
+        }
+        moduleInfo.metaData[j] = AllocZeroed<MetaData>(1);
+        if (moduleInfo.metaData[j] == nullptr || !reader.GetString(moduleInfo.metaData[j]->name) ||
+            !reader.GetString(moduleInfo.metaData[j]->value) || !reader.GetString(moduleInfo.metaData[j]->extra)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ReadAbilityInfo(TextRecordReader &reader, AbilityInfo &abilityInfo)
+{
+    int32_t abilityType = 0;
+    int32_t launchMode = 0;
+    if (!reader.GetBool(abilityInfo.isVisible) || !reader.GetInt(abilityType) || !reader.GetInt(launchMode)) {
+        return false;
+    }
+    abilityInfo.abilityType = static_cast<AbilityType>(abilityType);
+    abilityInfo.launchMode = static_cast<LaunchMode>(launchMode);
+    return reader.GetString(abilityInfo.moduleName) && reader.GetString(abilityInfo.name) &&
+        reader.GetString(abilityInfo.description) && reader.GetString(abilityInfo.iconPath) &&
+        reader.GetString(abilityInfo.deviceId) && reader.GetString(abilityInfo.label) &&
+        reader.GetString(abilityInfo.bundleName);
+}
+
+static bool ReadBundleInfo(TextRecordReader &reader, BundleInfo &bundleInfo)
+{
+    if (!reader.GetBool(bundleInfo.isKeepAlive) || !reader.GetBool(bundleInfo.isNativeApp) ||
+        !reader.GetInt(bundleInfo.uid) || !reader.GetInt(bundleInfo.gid) || !reader.GetBool(bundleInfo.isSystemApp) ||
+        !reader.GetInt(bundleInfo.compatibleApi) || !reader.GetInt(bundleInfo.targetApi) ||
+        !reader.GetInt(bundleInfo.versionCode) || !reader.GetString(bundleInfo.versionName) ||
+        !reader.GetString(bundleInfo.bundleName) || !reader.GetString(bundleInfo.label) ||
+        !reader.GetString(bundleInfo.bigIconPath) || !reader.GetString(bundleInfo.codePath) ||
+        !reader.GetString(bundleInfo.dataPath) || !reader.GetString(bundleInfo.vendor) ||
+        !reader.GetString(bundleInfo.appId)) {
+        return false;
+    }
+    int32_t numOfModule = 0;
+    if (!reader.GetInt(numOfModule) || numOfModule < 0) {
+        return false;
+    }
+    if (numOfModule > 0) {
+        bundleInfo.moduleInfos = AllocZeroed<ModuleInfo>(numOfModule);
+        if (bundleInfo.moduleInfos == nullptr) {
+            return false;
+        }
+        bundleInfo.numOfModule = numOfModule;
+    }
+    for (int32_t i = 0; i < numOfModule; i++) {
+        if (!ReadModuleInfo(reader, bundleInfo.moduleInfos[i])) {
+            return false;
+        }
+    }
+    int32_t numOfAbility = 0;
+    if (!reader.GetInt(numOfAbility) || numOfAbility < 0) {
+        return false;
+    }
+    if (numOfAbility > 0) {
+        bundleInfo.abilityInfos = AllocZeroed<AbilityInfo>(numOfAbility);
+        if (bundleInfo.abilityInfos == nullptr) {
+            return false;
+        }
+        bundleInfo.numOfAbility = numOfAbility;
+    }
+    for (int32_t i = 0; i < numOfAbility; i++) {
+        if (!ReadAbilityInfo(reader, bundleInfo.abilityInfos[i])) {
+            return false;
+        }
+    }
+    return bundleInfo.bundleName != nullptr;
+}
+
+BundleRegistrySnapshot::~BundleRegistrySnapshot()
+{
+    pthread_mutex_destroy(&mutex_);
+    pthread_mutex_destroy(&saveMutex_);
+}
+
+bool BundleRegistrySnapshot::GetFileStamp(const std::string &path, FileStamp &stamp)
+{
+    struct stat fileStat;
+    if (stat(path.c_str(), &fileStat) != 0) {
+        return false;
+    }
+    stamp.ino = static_cast<uint64_t>(fileStat.st_ino);
+    stamp.size = static_cast<uint64_t>(fileStat.st_size);
+    stamp.mtimeSec = static_cast<int64_t>(fileStat.st_mtim.tv_sec);
+    stamp.mtimeNsec = static_cast<int64_t>(fileStat.st_mtim.tv_nsec);
+    stamp.ctimeSec = static_cast<int64_t>(fileStat.st_ctim.tv_sec);
+    stamp.ctimeNsec = static_cast<int64_t>(fileStat.st_ctim.tv_nsec);
+    return true;
+}
+
+bool BundleRegistrySnapshot::IsSameStamp(const FileStamp &stamp, const FileStamp &otherStamp)
+{
+    return stamp.ino == otherStamp.ino && stamp.size == otherStamp.size && stamp.mtimeSec == otherStamp.mtimeSec &&
+        stamp.mtimeNsec == otherStamp.mtimeNsec && stamp.ctimeSec == otherStamp.ctimeSec &&
+        stamp.ctimeNsec == otherStamp.ctimeNsec;
+}
+
+std::string BundleRegistrySnapshot::GetLocale()
+{
+    // labels and descriptions are resolved for the locale of the parse
+    char language[MAX_LOCALE_LEN] = { 0 };
+    char region[MAX_LOCALE_LEN] = { 0 };
+    (void) GLOBAL_GetLanguage(language, MAX_LOCALE_LEN);
+    (void) GLOBAL_GetRegion(region, MAX_LOCALE_LEN);
+    language[MAX_LOCALE_LEN - 1] = '\0';
+    region[MAX_LOCALE_LEN - 1] = '\0';
+    return std::string(language) + "_" + region;
+}
+
+bool BundleRegistrySnapshot::ParseSnapshot()
+{
+    size_t payloadOffset = 0;
+    if (!TextRecordFile::Unseal(content_, SNAPSHOT_MAGIC, SNAPSHOT_FORMAT_VERSION, payloadOffset)) {
+        return false;
+    }
+    TextRecordReader reader(content_, payloadOffset, content_.size() - payloadOffset);
+    std::string locale;
+    int64_t hapNum = 0;
+    if (!reader.GetString(locale) || locale != GetLocale() || !reader.GetInt(hapNum) || hapNum < 0) {
+        return false;
+    }
+    for (int64_t i = 0; i < hapNum; i++) {
+        std::string hapPath;
+        HapEntry entry;
+        if (!reader.GetString(hapPath) || !GetStamp(reader, entry.stamp) || !reader.GetString(entry.bundleName) ||
+            !reader.GetInt(entry.versionCode)) {
+            return false;
+        }
+        haps_[hapPath] = std::move(entry);
+    }
+    int64_t bundleNum = 0;
+    if (!reader.GetInt(bundleNum) || bundleNum < 0) {
+        return false;
+    }
+    for (int64_t i = 0; i < bundleNum; i++) {
+        std::string bundleName;
+        BundleEntry entry;
+        if (!reader.GetString(bundleName) || !reader.GetInt(entry.recordSerial) || !reader.GetInt(entry.length)) {
+            return false;
+        }
+        // the bundle info itself is only decoded when it is asked for
+        entry.offset = reader.GetPos();
+        if (!reader.Skip(entry.length)) {
+            return false;
+        }
+        bundles_[bundleName] = entry;
+    }
+    return true;
+}
+
+bool BundleRegistrySnapshot::Load()
+{
+    Release();
+    if (!TextRecordFile::Read(REGISTRY_SNAPSHOT_PATH, MAX_SNAPSHOT_FILE_SIZE, content_)) {
+        content_.clear();
+        return false;
+    }
+    if (!ParseSnapshot()) {
+        HILOG_WARN(HILOG_MODULE_APP, "registry snapshot is stale or corrupted, drop it!");
+        Release();
+        BundleDaemonClient::GetInstance().RemoveFile(REGISTRY_SNAPSHOT_PATH);
+        return false;
+    }
+    return true;
+}
+
+void BundleRegistrySnapshot::Release()
+{
+    std::string().swap(content_);
+    haps_.clear();
+    bundles_.clear();
+}
+
+bool BundleRegistrySnapshot::GetHap(const std::string &hapPath, const FileStamp &stamp, std::string &bundleName,
+    int32_t &versionCode) const
+{
+    auto iter = haps_.find(hapPath);
+    if (iter == haps_.end() || !IsSameStamp(iter->second.stamp, stamp)) {
+        return false;
+    }
+    bundleName = iter->second.bundleName;
+    versionCode = iter->second.versionCode;
+    return true;
+}
+
+BundleInfo *BundleRegistrySnapshot::GetBundleInfo(const std::string &bundleName) const
+{
+    auto iter = bundles_.find(bundleName);
+    StoredRecord record;
+    if (iter == bundles_.end() || !InstallRecordStore::GetInstance().GetRecord(bundleName, record) ||
+        record.serial != iter->second.recordSerial) {
+        return nullptr;
+    }
+    BundleInfo *bundleInfo = AllocZeroed<BundleInfo>(1);
+    if (bundleInfo == nullptr) {
+        return nullptr;
+    }
+    TextRecordReader reader(content_, iter->second.offset, iter->second.length);
+    if (!ReadBundleInfo(reader, *bundleInfo) || reader.GetPos() != iter->second.offset + iter->second.length ||
+        bundleName != bundleInfo->bundleName) {
+        HILOG_WARN(HILOG_MODULE_APP, "decode %{public}s from registry snapshot fail!", bundleName.c_str());
+        BundleInfoUtils::FreeBundleInfo(bundleInfo);
+        return nullptr;
+    }
+    return bundleInfo;
+}
+
+void BundleRegistrySnapshot::SetHap(const std::string &hapPath, const FileStamp &stamp,
+    const std::string &bundleName, int32_t versionCode)
+{
+    HapEntry entry;
+    entry.stamp = stamp;
+    entry.bundleName = bundleName;
+    entry.versionCode = versionCode;
+    pthread_mutex_lock(&mutex_);
+    checkedHaps_[hapPath] = std::move(entry);
+    pthread_mutex_unlock(&mutex_);
+}
+
+void BundleRegistrySnapshot::SaveBundleInfo(const BundleInfo *bundleInfo, bool isStub, void *context)
+{
+    auto saveContext = static_cast<SaveContext *>(context);
+    StoredRecord storedRecord;
+    // without its install record the bundle is scanned at the next boot anyway, as is a bundle never loaded
+    if (isStub || bundleInfo->bundleName == nullptr ||
+        !InstallRecordStore::GetInstance().GetRecord(bundleInfo->bundleName, storedRecord)) {
+        return;
+    }
+    std::string record;
+    TextRecordWriter recordWriter(record);
+    WriteBundleInfo(recordWriter, *bundleInfo);
+    TextRecordWriter writer(saveContext->bundles);
+    writer.PutString(bundleInfo->bundleName);
+    writer.PutInt(static_cast<int64_t>(storedRecord.serial));
+    writer.PutInt(static_cast<int64_t>(record.size()));
+    saveContext->bundles += record;
+    saveContext->bundleNum++;
+}
+
+bool BundleRegistrySnapshot::Save(const BundleMap &bundleMap)
+{
+    std::string payload;
+    TextRecordWriter writer(payload);
+    writer.PutString(GetLocale());
+    pthread_mutex_lock(&saveMutex_);
+    pthread_mutex_lock(&mutex_);
+    writer.PutInt(static_cast<int64_t>(checkedHaps_.size()));
+    for (const auto &hap : checkedHaps_) {
+        writer.PutString(hap.first);
+        PutStamp(writer, hap.second.stamp);
+        writer.PutString(hap.second.bundleName);
+        writer.PutInt(hap.second.versionCode);
+    }
+    pthread_mutex_unlock(&mutex_);
+    SaveContext context;
+    bundleMap.ForEach(SaveBundleInfo, &context);
+    writer.PutInt(context.bundleNum);
+    payload += context.bundles;
+
+    std::string content = TextRecordFile::Seal(SNAPSHOT_MAGIC, SNAPSHOT_FORMAT_VERSION, payload);
+    bool isSaved = TextRecordFile::Write(REGISTRY_SNAPSHOT_PATH, content);
+    pthread_mutex_unlock(&saveMutex_);
+    if (!isSaved) {
+        HILOG_WARN(HILOG_MODULE_APP, "save registry snapshot fail!");
+        return false;
+    }
+    return true;
+}
+} // namespace OHOS
@@ -15,15 +15,45 @@
 
 #include "bundle_res_transform.h"
 
+#include <pthread.h>
+
 #include "ability_info_utils.h"
 #include "appexecfwk_errors.h"
 #include "bundle_info_utils.h"
 #include "bundle_util.h"
 #include "global.h"
+#include "hap_archive_reader.h"
 #include "log.h"
 #include "module_info_utils.h"
 
 namespace OHOS {
+namespace {
+// the global resource manager is not reentrant, the bundle parsers of several threads look values up one at a time
+pthread_mutex_t g_resourceMutex = PTHREAD_MUTEX_INITIALIZER;
+
+int32_t GetResValueById(uint32_t id, const std::string &path, char **value)
+{
+    pthread_mutex_lock(&g_resourceMutex);
+    int32_t ret = GLOBAL_GetValueById(id, path.c_str(), value);
+    pthread_mutex_unlock(&g_resourceMutex);
+    return ret;
+}
+
+// a module installed in archive mode keeps its media files in the hap instead of on disk
+bool IsFileInArchive(const BundleInfo *bundleInfo, const std::string &filePath)
+{
+    std::string moduleCodePath = std::string(bundleInfo->codePath) + PATH_SEPARATOR +
+        bundleInfo->moduleInfos[0].moduleName;
+    if (!HapArchiveReader::IsArchiveModule(moduleCodePath)) {
+        return false;
+    }
+    HapArchiveReader archiveReader(moduleCodePath);
+    std::string entryName;
+    return archiveReader.Init() && archiveReader.GetEntryName(filePath, entryName) &&
+        archiveReader.HasEntry(entryName);
+}
+}
+
 uint8_t BundleResTransform::ConvertResInfoToBundleInfo(const std::string &path, const BundleRes &bundleRes,
     BundleInfo *bundleInfo)
 {
@@ -43,7 +73,7 @@ uint8_t BundleResTransform::ConvertResInfoToBundleInfo(const std::string &path,
             HILOG_ERROR(HILOG_MODULE_APP, "resource index is not exists!");
             return ERR_APPEXECFWK_INSTALL_FAILED_RESOURCE_INDEX_NOT_EXISTS;
         }
-        if (GLOBAL_GetValueById(bundleRes.moduleDescriptionId, resPath.c_str(), &des) < 0) {
+        if (GetResValueById(bundleRes.moduleDescriptionId, resPath, &des) < 0) {
             HILOG_ERROR(HILOG_MODULE_APP, "get moduleInfo description resId fail!");
             return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_DESCRIPTION_RES_ERROR;
         }
@@ -83,14 +113,14 @@ bool BundleResTransform::ConvertIconResToBundleInfo(const std::string &path, uin
     }
 
     char *relativeIconPath = nullptr;
-    if (GLOBAL_GetValueById(iconId, path.c_str(), &relativeIconPath) != 0) {
+    if (GetResValueById(iconId, path, &relativeIconPath) != 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "get icon resId fail!");
         return false;
     }
 
     std::string iconPath = std::string(bundleInfo->codePath) + PATH_SEPARATOR + bundleInfo->moduleInfos[0].moduleName +
         ASSETS + relativeIconPath;
-    if (!BundleUtil::IsFile(iconPath.c_str())) {
+    if (!BundleUtil::IsFile(iconPath.c_str()) && !IsFileInArchive(bundleInfo, iconPath)) {
         HILOG_ERROR(HILOG_MODULE_APP, "icon is not exists!");
         AdapterFree(relativeIconPath);
         return false;
@@ -123,7 +153,7 @@ bool BundleResTransform::ConvertLableResToBundleInfo(const std::string &path, ui
     }
 
     char *label = nullptr;
-    if (GLOBAL_GetValueById(labelId, path.c_str(), &label) != 0) {
+    if (GetResValueById(labelId, path, &label) != 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "get laebl resId fail!");
         return false;
     }
@@ -155,7 +185,7 @@ bool BundleResTransform::ConvertDesResIdToBundleInfo(const std::string &path, ui
     }
 
     char *description = nullptr;
-    if (GLOBAL_GetValueById(desId, path.c_str(), &description) != 0) {
+    if (GetResValueById(desId, path, &description) != 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "get description resId fail!");
         return false;
     }
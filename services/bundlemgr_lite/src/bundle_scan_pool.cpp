@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_scan_pool.h"
+
+#include <unistd.h>
+#include <vector>
+
+#include "log.h"
+
+namespace OHOS {
+namespace {
+// the scan reads flash more than it computes, a few threads already keep the device queue busy
+constexpr uint32_t MAX_SCAN_WORKER_NUM = 4;
+}
+
+BundleScanPool::BundleScanPool(Task task, void *context) : task_(task), context_(context) {}
+
+BundleScanPool::~BundleScanPool()
+{
+    pthread_mutex_destroy(&mutex_);
+}
+
+uint32_t BundleScanPool::GetWorkerNum(uint32_t num)
+{
+    long cpuNum = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t workerNum = (cpuNum > 1) ? static_cast<uint32_t>(cpuNum) : 1;
+    if (workerNum > MAX_SCAN_WORKER_NUM) {
+        workerNum = MAX_SCAN_WORKER_NUM;
+    }
+    if (workerNum > num) {
+        workerNum = num;
+    }
+    // the calling thread is one of them
+    return (workerNum > 0) ? workerNum - 1 : 0;
+}
+
+void BundleScanPool::Run(uint32_t num)
+{
+    if (task_ == nullptr) {
+        return;
+    }
+    num_ = num;
+    next_ = 0;
+    std::vector<pthread_t> workers;
+    uint32_t workerNum = GetWorkerNum(num);
+    for (uint32_t i = 0; i < workerNum; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, nullptr, WorkerRoutine, this) != 0) {
+            // the calling thread still runs whatever is left
+            HILOG_WARN(HILOG_MODULE_APP, "create scan worker fail!");
+            break;
+        }
+        workers.push_back(worker);
+    }
+    RunTasks();
+    for (pthread_t worker : workers) {
+        pthread_join(worker, nullptr);
+    }
+}
+
+void *BundleScanPool::WorkerRoutine(void *arg)
+{
+    static_cast<BundleScanPool *>(arg)->RunTasks();
+    return nullptr;
+}
+
+void BundleScanPool::RunTasks()
+{
+    while (true) {
+        pthread_mutex_lock(&mutex_);
+        uint32_t index = next_;
+        if (index < num_) {
+            next_++;
+        }
+        pthread_mutex_unlock(&mutex_);
+        if (index >= num_) {
+            return;
+        }
+        task_(context_, index);
+    }
+}
+} // namespace OHOS
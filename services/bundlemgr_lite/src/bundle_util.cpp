@@ -48,6 +48,10 @@ const int32_t MAX_JSON_SIZE = 1024 * 64;
 #else
 const uint32_t MAX_JSON_SIZE = 1024 * 64;
 #endif
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+// leaves room for the path in a daemon request
+const size_t MAX_STORE_CHUNK_SIZE = 4 * 1024;
+#endif
 
 /*
  * path should not include ".." or "./" or ".\0"
@@ -600,160 +604,31 @@ void BundleUtil::CreateRandStr(char *str, uint32_t len)
 }
 
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-cJSON *BundleUtil::ObtainUidAndGidJson(bool flag)
+bool BundleUtil::StoreContentInChunks(const char *file, const std::string &content)
 {
-    std::string uidJsonPath = std::string(JSON_PATH) + UID_GID_MAP + JSON_SUFFIX;
-    cJSON *object = BundleUtil::GetJsonStream(uidJsonPath.c_str());
-    if ((object != nullptr) || (!flag)) {
-        return object;
-    }
-
-    object = cJSON_CreateObject();
-    if (object == nullptr) {
-        return nullptr;
-    }
-    cJSON *size = cJSON_CreateNumber(0);
-    if (size == nullptr) {
-        cJSON_Delete(object);
-        return nullptr;
-    }
-    if (!cJSON_AddItemToObject(object, PROFILE_KEY_UID_SIZE, size)) {
-        cJSON_Delete(size);
-        cJSON_Delete(object);
-        return nullptr;
-    }
-    cJSON *uids = cJSON_AddArrayToObject(object, PROFILE_KEY_UID_AND_GID);
-    if (uids == nullptr) {
-        cJSON_Delete(object);
-        return nullptr;
-    }
-    return object;
-}
-
-bool BundleUtil::AddUidAndGidInfo(const InstallRecord &installRecord, cJSON *size, cJSON *uids)
-{
-    if ((size == nullptr) || (uids == nullptr)) {
-        return false;
-    }
-    cJSON_SetNumberValue(size, size->valueint + 1);
-    cJSON *uid = cJSON_CreateObject();
-    if (uid == nullptr) {
+    if (file == nullptr || content.empty()) {
         return false;
     }
-    if ((cJSON_AddStringToObject(uid, JSON_SUB_KEY_PACKAGE, installRecord.bundleName) == nullptr) ||
-        (cJSON_AddNumberToObject(uid, JSON_SUB_KEY_UID, installRecord.uid) == nullptr) ||
-        (cJSON_AddNumberToObject(uid, JSON_SUB_KEY_GID, installRecord.gid) == nullptr)) {
-        cJSON_Delete(uid);
+    // the chunks go to a temporary file first, a reader never sees a partly written file
+    std::string tmpFile = std::string(file) + TMP_FILE_SUFFIX;
+    BundleDaemonClient &client = BundleDaemonClient::GetInstance();
+    if (IsFile(tmpFile.c_str()) && client.RemoveFile(tmpFile.c_str()) != EC_SUCCESS) {
         return false;
     }
-    if (!cJSON_AddItemToArray(uids, uid)) {
-        cJSON_Delete(uid);
-        return false;
-    }
-    return true;
-}
-
-cJSON *BundleUtil::ConvertUidAndGidToJson(const InstallRecord &installRecord)
-{
-    if (installRecord.bundleName == nullptr) {
-        return nullptr;
-    }
-
-    cJSON *object = ObtainUidAndGidJson(true);
-    if (object == nullptr) {
-        return nullptr;
-    }
-
-    cJSON *size = cJSON_GetObjectItemCaseSensitive(object, PROFILE_KEY_UID_SIZE);
-    if (!cJSON_IsNumber(size)) {
-        cJSON_Delete(object);
-        return nullptr;
-    }
-    cJSON *uids = cJSON_GetObjectItemCaseSensitive(object, PROFILE_KEY_UID_AND_GID);
-    if (!cJSON_IsArray(uids)) {
-        cJSON_Delete(object);
-        return nullptr;
-    }
-
-    cJSON *item = nullptr;
-    cJSON_ArrayForEach(item, uids) {
-        cJSON *innerBundleName = cJSON_GetObjectItemCaseSensitive(item, JSON_SUB_KEY_PACKAGE);
-        if ((cJSON_IsString(innerBundleName)) && (innerBundleName->valuestring != nullptr)) {
-            if (strcmp(innerBundleName->valuestring, installRecord.bundleName) == 0) {
-                return object;
-            }
-        }
-    }
-
-    if (!AddUidAndGidInfo(installRecord, size, uids)) {
-        cJSON_Delete(object);
-        return nullptr;
-    }
-
-    return object;
-}
-
-bool BundleUtil::DeleteInnerUidInfoFromUidArray(const char *bundleName, cJSON *size, cJSON *uids)
-{
-    if ((size == nullptr) || (uids == nullptr) || (bundleName == nullptr)) {
-        return false;
-    }
-    cJSON *uid = nullptr;
-    int32_t index = -1;
-    bool isFound = false;
-    cJSON_ArrayForEach(uid, uids) {
-        index++;
-        cJSON *innerBundleName = cJSON_GetObjectItemCaseSensitive(uid, JSON_SUB_KEY_PACKAGE);
-        if ((cJSON_IsString(innerBundleName)) && (innerBundleName->valuestring != nullptr)) {
-            if (strcmp(innerBundleName->valuestring, bundleName) == 0) {
-                isFound = true;
-                break;
-            }
+    for (size_t offset = 0; offset < content.size(); offset += MAX_STORE_CHUNK_SIZE) {
+        std::string chunk = content.substr(offset, MAX_STORE_CHUNK_SIZE);
+        // only the last chunk syncs, one flush of the whole file before it is renamed into place
+        bool isLast = offset + MAX_STORE_CHUNK_SIZE >= content.size();
+        if (client.AppendContentToFile(tmpFile.c_str(), chunk.c_str(), static_cast<uint32_t>(chunk.size()),
+            isLast) != EC_SUCCESS) {
+            client.RemoveFile(tmpFile.c_str());
+            return false;
         }
     }
-    if (isFound) {
-        cJSON_DeleteItemFromArray(uids, index);
-        cJSON_SetNumberValue(size, size->valueint - 1);
-    }
-    return true;
-}
-
-bool BundleUtil::DeleteUidInfoFromJson(const char *bundleName)
-{
-    cJSON *object = ObtainUidAndGidJson(false);
-    if (object == nullptr) {
-        return false;
-    }
-
-    cJSON *size = cJSON_GetObjectItemCaseSensitive(object, PROFILE_KEY_UID_SIZE);
-    if (!cJSON_IsNumber(size)) {
-        cJSON_Delete(object);
-        return false;
-    }
-    cJSON *uids = cJSON_GetObjectItemCaseSensitive(object, PROFILE_KEY_UID_AND_GID);
-    if (!cJSON_IsArray(uids)) {
-        cJSON_Delete(object);
-        return false;
-    }
-    if (!DeleteInnerUidInfoFromUidArray(bundleName, size, uids)) {
-        cJSON_Delete(object);
+    if (client.RenameFile(tmpFile.c_str(), file) != EC_SUCCESS) {
+        client.RemoveFile(tmpFile.c_str());
         return false;
     }
-
-    std::string uidJsonPath = std::string(JSON_PATH) + UID_GID_MAP + JSON_SUFFIX;
-    if (size->valueint == 0) {
-        BundleDaemonClient::GetInstance().RemoveFile(uidJsonPath.c_str());
-    } else {
-        char *out = cJSON_Print(object);
-        if (out == nullptr) {
-            cJSON_Delete(object);
-            return false;
-        }
-        BundleDaemonClient::GetInstance().StoreContentToFile(uidJsonPath.c_str(), out, strlen(out) + 1);
-        cJSON_free(out);
-    }
-
-    cJSON_Delete(object);
     return true;
 }
 #else
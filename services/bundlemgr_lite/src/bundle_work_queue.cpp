@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_work_queue.h"
+
+#include <algorithm>
+
+#include "log.h"
+
+namespace OHOS {
+BundleWorkQueue::BundleWorkQueue(uint32_t concurrency, WorkHandler handler)
+    : handler_(handler), concurrency_((concurrency == 0) ? 1 : concurrency)
+{
+}
+
+bool BundleWorkQueue::Push(BundleWork &&work)
+{
+    if (work.priority >= WORK_PRIORITY_NUM || handler_ == nullptr) {
+        return false;
+    }
+    pthread_mutex_lock(&mutex_);
+    if (!StartWorkers()) {
+        pthread_mutex_unlock(&mutex_);
+        return false;
+    }
+    work.seq = nextSeq_++;
+    works_[work.priority].push_back(std::move(work));
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+    return true;
+}
+
+void BundleWorkQueue::GetState(BundleWorkQueueState &state)
+{
+    pthread_mutex_lock(&mutex_);
+    for (uint8_t i = 0; i < WORK_PRIORITY_NUM; i++) {
+        state.pending[i] = static_cast<uint32_t>(works_[i].size());
+    }
+    state.running = running_;
+    state.concurrency = concurrency_;
+    pthread_mutex_unlock(&mutex_);
+}
+
+void BundleWorkQueue::AcquireBundles(const std::vector<std::string> &bundleNames)
+{
+    pthread_mutex_lock(&mutex_);
+    // the works holding them acquire nothing more, so this wait always ends
+    while (std::any_of(bundleNames.begin(), bundleNames.end(),
+        [this](const std::string &bundleName) { return runningBundles_.count(bundleName) != 0; })) {
+        pthread_cond_wait(&cond_, &mutex_);
+    }
+    runningBundles_.insert(bundleNames.begin(), bundleNames.end());
+    pthread_mutex_unlock(&mutex_);
+}
+
+void BundleWorkQueue::ReleaseBundles(const std::vector<std::string> &bundleNames)
+{
+    pthread_mutex_lock(&mutex_);
+    for (const auto &bundleName : bundleNames) {
+        runningBundles_.erase(bundleName);
+    }
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+bool BundleWorkQueue::StartWorkers()
+{
+    while (workerNum_ < concurrency_) {
+        pthread_t worker;
+        if (pthread_create(&worker, nullptr, WorkerRoutine, this) != 0) {
+            HILOG_ERROR(HILOG_MODULE_APP, "create bundle worker fail!");
+            // a smaller pool still drains the queue
+            return workerNum_ > 0;
+        }
+        pthread_detach(worker);
+        workerNum_++;
+    }
+    return true;
+}
+
+void *BundleWorkQueue::WorkerRoutine(void *arg)
+{
+    auto queue = static_cast<BundleWorkQueue *>(arg);
+    while (true) {
+        BundleWork work;
+        pthread_mutex_lock(&queue->mutex_);
+        while (!queue->TakeRunnable(work)) {
+            pthread_cond_wait(&queue->cond_, &queue->mutex_);
+        }
+        pthread_mutex_unlock(&queue->mutex_);
+
+        queue->handler_(work);
+
+        pthread_mutex_lock(&queue->mutex_);
+        queue->Finish(work);
+        pthread_cond_broadcast(&queue->cond_);
+        pthread_mutex_unlock(&queue->mutex_);
+    }
+    return nullptr;
+}
+
+bool BundleWorkQueue::IsRunnable(const BundleWork &work) const
+{
+    if (exclusiveRunning_ || (work.exclusive && running_ != 0)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < WORK_PRIORITY_NUM; i++) {
+        for (const auto &pending : works_[i]) {
+            if (pending.seq >= work.seq) {
+                break;
+            }
+            if (work.exclusive || pending.exclusive) {
+                return false;
+            }
+        }
+    }
+    for (const auto &bundleName : work.bundleNames) {
+        if (runningBundles_.count(bundleName) != 0) {
+            return false;
+        }
+        // an earlier work of the same bundle may wait in a lower priority
+        for (uint8_t i = 0; i < WORK_PRIORITY_NUM; i++) {
+            for (const auto &pending : works_[i]) {
+                if (pending.seq >= work.seq) {
+                    break;
+                }
+                for (const auto &name : pending.bundleNames) {
+                    if (name == bundleName) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool BundleWorkQueue::TakeRunnable(BundleWork &work)
+{
+    for (uint8_t i = 0; i < WORK_PRIORITY_NUM; i++) {
+        for (auto it = works_[i].begin(); it != works_[i].end(); ++it) {
+            if (!IsRunnable(*it)) {
+                continue;
+            }
+            work = std::move(*it);
+            works_[i].erase(it);
+            for (const auto &bundleName : work.bundleNames) {
+                runningBundles_.insert(bundleName);
+            }
+            exclusiveRunning_ = work.exclusive;
+            running_++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void BundleWorkQueue::Finish(const BundleWork &work)
+{
+    for (const auto &bundleName : work.bundleNames) {
+        runningBundles_.erase(bundleName);
+    }
+    if (work.exclusive) {
+        exclusiveRunning_ = false;
+    }
+    running_--;
+}
+} // namespace OHOS
@@ -15,15 +15,92 @@
 
 #include "extractor_util.h"
 
+#include <cerrno>
 #include <dirent.h>
 #include <fcntl.h>
-#include <fstream>
+#include <ostream>
+#include <streambuf>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include "log.h"
 
 namespace OHOS {
+namespace {
+constexpr mode_t EXTRACT_FILE_MODE = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+constexpr size_t FD_BUFFER_SIZE = 4096;
+
+// unbuffered for large writes, so inflated chunks go straight from the zip buffer to the fd.
+class FdOutBuf : public std::streambuf {
+public:
+    explicit FdOutBuf(int32_t fd) : fd_(fd)
+    {
+        setp(buffer_, buffer_ + FD_BUFFER_SIZE);
+    }
+
+    ~FdOutBuf() override = default;
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!Flush()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char *data, std::streamsize count) override
+    {
+        if (count < static_cast<std::streamsize>(epptr() - pptr())) {
+            return std::streambuf::xsputn(data, count);
+        }
+        if (!Flush() || !WriteAll(data, static_cast<size_t>(count))) {
+            return 0;
+        }
+        return count;
+    }
+
+    int sync() override
+    {
+        return Flush() ? 0 : -1;
+    }
+
+private:
+    bool Flush()
+    {
+        size_t length = static_cast<size_t>(pptr() - pbase());
+        if (length > 0 && !WriteAll(pbase(), length)) {
+            return false;
+        }
+        setp(buffer_, buffer_ + FD_BUFFER_SIZE);
+        return true;
+    }
+
+    bool WriteAll(const char *data, size_t length)
+    {
+        while (length > 0) {
+            ssize_t writeBytes = write(fd_, data, length);
+            if (writeBytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (writeBytes <= 0) {
+                return false;
+            }
+            data += writeBytes;
+            length -= static_cast<size_t>(writeBytes);
+        }
+        return true;
+    }
+
+    int32_t fd_;
+    char buffer_[FD_BUFFER_SIZE];
+};
+}
+
 ExtractorUtil::ExtractorUtil(const std::string &filePath) : zipFile_(filePath) {}
 
 ExtractorUtil::~ExtractorUtil() {}
@@ -50,35 +127,64 @@ bool ExtractorUtil::ExtractFileByName(const std::string &fileName, std::ostream
     return true;
 }
 
-bool ExtractorUtil::ExtractFileToPath(const std::string &filePath, const std::string &fileName) const
+bool ExtractorUtil::ExtractFileToFd(int32_t fd, const std::string &fileName) const
 {
-    std::ofstream fileStream;
-    fileStream.open(filePath, std::ios_base::out | std::ios_base::binary);
-    if (!fileStream.is_open()) {
-        HILOG_ERROR(HILOG_MODULE_APP, "ExtractFileToPath fileStream open fail");
+    if (!initial_ || fd < 0) {
         return false;
     }
-    if ((!zipFile_.ExtractFile(fileName, fileStream)) || (!fileStream.good())) {
-        fileStream.clear();
-        fileStream.close();
-        remove(filePath.c_str());
-        return false;
+    // stored entries are copied by the kernel, anything else or any failure there goes through the stream.
+    bool result = zipFile_.CopyStoredFile(fileName, fd);
+    if (!result) {
+        // a compressed entry is refused before anything is written, so the space preallocated for fd is kept
+        if (lseek(fd, 0, SEEK_CUR) != 0 && (ftruncate(fd, 0) != 0 || lseek(fd, 0, SEEK_SET) != 0)) {
+            HILOG_ERROR(HILOG_MODULE_APP, "ExtractFileToFd reset fd fail");
+            return false;
+        }
+        FdOutBuf outBuf(fd);
+        std::ostream fileStream(&outBuf);
+        result = zipFile_.ExtractFile(fileName, fileStream) && fileStream.flush().good();
     }
-    fileStream.clear();
-    fileStream.close();
+    if (result && syncMode_ == SYNC_EACH_FILE) {
+        fsync(fd);
+    }
+    return result;
+}
 
-    int fd = open(filePath.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+bool ExtractorUtil::ExtractFileToPath(const std::string &filePath, const std::string &fileName) const
+{
+    int32_t fd = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, EXTRACT_FILE_MODE);
     if (fd < 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "ExtractFileToPath open fail");
         return false;
     }
-    fsync(fd);
+    bool result = ExtractFileToFd(fd, fileName);
     close(fd);
-    return true;
+    if (!result) {
+        remove(filePath.c_str());
+    }
+    return result;
+}
+
+void ExtractorUtil::SetSyncMode(ExtractSyncMode syncMode)
+{
+    syncMode_ = syncMode;
 }
 
-const std::vector<std::string> &ExtractorUtil::GetZipFileNames() const
+void ExtractorUtil::SetReadHint(FileReadHint hint, bool dropCacheOnClose)
+{
+    zipFile_.SetReadHint(hint, dropCacheOnClose);
+}
+
+const std::vector<ZipEntryName> &ExtractorUtil::GetZipFileNames() const
 {
     return zipFile_.GetFileNames();
 }
-} // namespace OHOS
\ No newline at end of file
+
+bool ExtractorUtil::GetEntry(const std::string &fileName, ZipEntry &zipEntry) const
+{
+    if (!initial_) {
+        return false;
+    }
+    return zipFile_.GetEntry(fileName, zipEntry);
+}
+} // namespace OHOS
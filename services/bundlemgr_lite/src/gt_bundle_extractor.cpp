@@ -27,6 +27,7 @@ extern "C" {
 #include "bundle_util.h"
 #include "bundlems_log.h"
 #include "fcntl.h"
+#include "file_read_hint.h"
 #include "gt_bundle_manager_service.h"
 #include "gt_bundle_parser.h"
 #include "gt_extractor_util.h"
@@ -55,7 +56,7 @@ uint8_t GtBundleExtractor::ExtractFileDataPos(int32_t fp, uint64_t &filePos)
 }
 
 uint8_t GtBundleExtractor::ExtractHap(const char *codePath, const char *bundleName, int32_t fp, uint32_t totalFileSize,
-    uint8_t bundleStyle)
+    uint8_t bundleStyle, InstallTrace *trace)
 {
     char *relativeFilePath = nullptr;
     char *fileName = nullptr;
@@ -71,6 +72,7 @@ uint8_t GtBundleExtractor::ExtractHap(const char *codePath, const char *bundleNa
         return errorCode;
     }
 
+    AdviseFileRead(fp, 0, 0, FILE_READ_HINT_SEQUENTIAL);
     while (index < totalFileSize) {
         errorCode = GtExtractorUtil::ExtractFileToPath(codePath, fp, fileSize, &fileName, &relativeFilePath);
         if (errorCode != ERR_OK) {
@@ -79,11 +81,17 @@ uint8_t GtBundleExtractor::ExtractHap(const char *codePath, const char *bundleNa
             return errorCode;
         }
         index = index + INT_LENGTH + strlen(fileName) + INT_LENGTH + strlen(relativeFilePath) + LONG_LENGTH + fileSize;
+        if (trace != nullptr) {
+            // the bin keeps its files uncompressed
+            trace->AddIo(static_cast<uint32_t>(fileSize), static_cast<uint32_t>(fileSize), 1);
+        }
         UI_Free(relativeFilePath);
         UI_Free(fileName);
         relativeFilePath = nullptr;
         fileName = nullptr;
     }
+    // the bin is not read again after extraction
+    AdviseFileDrop(fp, 0, 0);
     return errorCode;
 }
 
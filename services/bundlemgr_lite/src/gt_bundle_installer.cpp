@@ -166,6 +166,14 @@ uint8_t GtBundleInstaller::SwitchErrorCode(int32_t errorCode)
 }
 
 uint8_t GtBundleInstaller::Install(const char *path, InstallerCallback installerCallback)
+{
+    trace_.Start();
+    uint8_t errorCode = InstallHap(path, installerCallback);
+    trace_.Finish(errorCode);
+    return errorCode;
+}
+
+uint8_t GtBundleInstaller::InstallHap(const char *path, InstallerCallback installerCallback)
 {
     if (path == nullptr) {
         return ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
@@ -237,6 +245,7 @@ uint8_t GtBundleInstaller::ProcessBundleInstall(const char *path, const char *ra
     BundleInfo *bundleInfo = nullptr;
     (void) GtManagerService::GetInstance().ReportInstallCallback(OPERATION_DOING, 0,
         BMS_FIRST_FINISHED_PROCESS, installerCallback);
+    trace_.BeginPhase(INSTALL_PHASE_VERIFY);
     uint8_t errorCode = PreCheckBundle(path, fp, signatureInfo, fileSize, bundleStyle);
     CHECK_PRO_RESULT(errorCode, fp, permissions, bundleInfo, signatureInfo);
     (void) GtManagerService::GetInstance().ReportInstallCallback(OPERATION_DOING,
@@ -250,14 +259,17 @@ uint8_t GtBundleInstaller::ProcessBundleInstall(const char *path, const char *ra
     CHECK_PRO_RESULT(errorCode, fp, permissions, bundleInfo, signatureInfo);
 #endif
     // parse HarmoyProfile.json, get permissions and bundleInfo
+    trace_.BeginPhase(INSTALL_PHASE_PARSE);
     errorCode = GtBundleParser::ParseHapProfile(fp, fileSize, permissions, bundleRes, &bundleInfo);
     CHECK_PRO_RESULT(errorCode, fp, permissions, bundleInfo, signatureInfo);
+    trace_.SetBundleName(bundleInfo->bundleName);
     SetCurrentBundle(bundleInfo->bundleName);
     // terminate current runing app
     uint32_t labelId = (bundleRes.abilityRes != nullptr) ? bundleRes.abilityRes->labelId : 0;
     uint32_t iconId = (bundleRes.abilityRes != nullptr) ? bundleRes.abilityRes->iconId : 0;
     AdapterFree(bundleRes.abilityRes);
     // check signatureInfo
+    trace_.BeginPhase(INSTALL_PHASE_VERIFY);
     errorCode = CheckProvisionInfoIsValid(signatureInfo, permissions, bundleInfo->bundleName);
     CHECK_PRO_RESULT(errorCode, fp, permissions, bundleInfo, signatureInfo);
     installRecord.codePath = bundleInfo->codePath;
@@ -273,7 +285,9 @@ uint8_t GtBundleInstaller::ProcessBundleInstall(const char *path, const char *ra
     char *tmpCodePath = BundleUtil::Strscat(tmpCodePathComp, sizeof(tmpCodePathComp) / sizeof(char *));
     errorCode = (tmpCodePath == nullptr) ? ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR : ERR_OK;
     CHECK_PRO_RESULT(errorCode, fp, permissions, bundleInfo, signatureInfo);
-    errorCode = GtBundleExtractor::ExtractHap(tmpCodePath, installRecord.bundleName, fp, fileSize, bundleStyle);
+    trace_.BeginPhase(INSTALL_PHASE_EXTRACT);
+    errorCode = GtBundleExtractor::ExtractHap(tmpCodePath, installRecord.bundleName, fp, fileSize, bundleStyle,
+        &trace_);
     close(fp);
     CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, signatureInfo);
     (void) GtManagerService::GetInstance().ReportInstallCallback(OPERATION_DOING, 0,
@@ -285,6 +299,7 @@ uint8_t GtBundleInstaller::ProcessBundleInstall(const char *path, const char *ra
     CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, signatureInfo);
     installRecord.jsEngineVersion = jsEngineVersion;
     // try to transform js file to bc file
+    trace_.BeginPhase(INSTALL_PHASE_TRANSFORM);
     errorCode = TransformJsToBc(tmpCodePath, installRecord);
     CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, signatureInfo);
 #endif
@@ -292,6 +307,7 @@ uint8_t GtBundleInstaller::ProcessBundleInstall(const char *path, const char *ra
         BMS_FOURTH_FINISHED_PROCESS, installerCallback);
     // rename install path and record install infomation
     bool isUpdate = GtManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName) != nullptr;
+    trace_.BeginPhase(INSTALL_PHASE_RECORD);
     errorCode = HandleFileAndBackUpRecord(installRecord, tmpCodePath, randStr, bundleInfo->dataPath, isUpdate);
     AdapterFree(tmpCodePath);
     CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, signatureInfo, randStr);
@@ -302,6 +318,7 @@ uint8_t GtBundleInstaller::ProcessBundleInstall(const char *path, const char *ra
     (void) GtManagerService::GetInstance().ReportInstallCallback(OPERATION_DOING, 0,
         BMS_FIFTH_FINISHED_PROCESS, installerCallback);
     // store permissions
+    trace_.BeginPhase(INSTALL_PHASE_PERMISSION);
     errorCode = StorePermissions(installRecord.bundleName, permissions.permissionTrans, permissions.permNum,
         isUpdate);
     CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, signatureInfo, randStr);
@@ -515,10 +532,12 @@ uint8_t GtBundleInstaller::UpdateBundleInfo(uint8_t bundleStyle, uint32_t labelI
         return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_JS_DIR_ERROR;
     }
 
+    trace_.BeginPhase(INSTALL_PHASE_TRANSFORM);
     uint8_t errorCode = GtBundleParser::ConvertResInfoToBundleInfo(bundleInfo->codePath, labelId, iconId, bundleInfo);
     if (errorCode != ERR_OK) {
         return errorCode;
     }
+    trace_.BeginPhase(INSTALL_PHASE_RECORD);
     if (!isUpdate) {
         if (bundleStyle == SYSTEM_APP_FLAG) {
             bundleInfo->isSystemApp = true;
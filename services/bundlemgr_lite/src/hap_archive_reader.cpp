@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hap_archive_reader.h"
+
+#include "bundle_common.h"
+#include "bundle_util.h"
+#include "log.h"
+
+namespace OHOS {
+HapArchiveReader::HapArchiveReader(const std::string &moduleCodePath)
+    : moduleCodePath_(moduleCodePath), zipFile_(moduleCodePath + PATH_SEPARATOR + ARCHIVE_HAP_NAME)
+{
+    while (moduleCodePath_.size() > 1 && moduleCodePath_.back() == PATH_SEPARATOR[0]) {
+        moduleCodePath_.pop_back();
+    }
+}
+
+bool HapArchiveReader::IsArchiveModule(const std::string &moduleCodePath)
+{
+    std::string archivePath = moduleCodePath + PATH_SEPARATOR + ARCHIVE_HAP_NAME;
+    return BundleUtil::IsFile(archivePath.c_str());
+}
+
+bool HapArchiveReader::Init()
+{
+    // assets are read at random by the runtime
+    zipFile_.SetReadHint(FILE_READ_HINT_NONE, false);
+    if (!zipFile_.Open()) {
+        HILOG_ERROR(HILOG_MODULE_APP, "HapArchiveReader open archive fail");
+        return false;
+    }
+    initial_ = true;
+    return true;
+}
+
+bool HapArchiveReader::HasEntry(const std::string &entryName) const
+{
+    uint32_t size = 0;
+    return GetEntrySize(entryName, size);
+}
+
+bool HapArchiveReader::GetEntrySize(const std::string &entryName, uint32_t &size) const
+{
+    if (!initial_ || entryName.empty()) {
+        return false;
+    }
+    ZipEntry zipEntry;
+    if (!zipFile_.GetEntry(entryName, zipEntry)) {
+        return false;
+    }
+    size = zipEntry.uncompressedSize;
+    return true;
+}
+
+bool HapArchiveReader::ReadEntry(const std::string &entryName, std::ostream &dest) const
+{
+    if (!initial_ || entryName.empty() || !dest.good()) {
+        return false;
+    }
+    if (!zipFile_.ExtractFile(entryName, dest)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "HapArchiveReader read entry fail");
+        return false;
+    }
+    return true;
+}
+
+bool HapArchiveReader::GetEntryName(const std::string &filePath, std::string &entryName) const
+{
+    std::string prefix = moduleCodePath_ + PATH_SEPARATOR;
+    if (filePath.size() <= prefix.size() || filePath.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    entryName = filePath.substr(prefix.size());
+    // asset paths are built as module + ASSETS + relative path, which may leave a doubled separator
+    std::string::size_type pos = 0;
+    while ((pos = entryName.find("//", pos)) != std::string::npos) {
+        entryName.erase(pos, 1);
+    }
+    if (entryName.find("..") != std::string::npos) {
+        entryName.clear();
+        return false;
+    }
+    return !entryName.empty();
+}
+} // namespace OHOS
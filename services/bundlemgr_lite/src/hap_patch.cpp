@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hap_patch.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <new>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "zlib.h"
+
+namespace OHOS {
+namespace {
+const char PATCH_MAGIC[] = "HAPPATCH";
+constexpr uint32_t PATCH_FORMAT_VERSION = 1;
+constexpr uint16_t MAX_BUNDLE_NAME_LENGTH = 127;
+constexpr uint32_t COPY_BUFFER_SIZE = 16 * 1024;
+}
+
+HapPatch::HapPatch(const std::string &patchPath) : patchPath_(patchPath)
+{
+}
+
+HapPatch::~HapPatch()
+{
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool HapPatch::Open()
+{
+    if (fd_ >= 0) {
+        return true;
+    }
+    fd_ = open(patchPath_.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "open patch file fail, error: %{public}d", errno);
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd_, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        return false;
+    }
+    patchSize_ = static_cast<uint64_t>(fileStat.st_size);
+    readPos_ = 0;
+
+    HapPatchFileHeader fileHeader;
+    if (!ReadPatch(&fileHeader, sizeof(fileHeader)) ||
+        memcmp(fileHeader.magic, PATCH_MAGIC, sizeof(fileHeader.magic)) != 0 ||
+        fileHeader.version != PATCH_FORMAT_VERSION || fileHeader.bundleNameLength == 0 ||
+        fileHeader.bundleNameLength > MAX_BUNDLE_NAME_LENGTH) {
+        HILOG_ERROR(HILOG_MODULE_APP, "patch file header is invalid");
+        return false;
+    }
+    std::string bundleName(fileHeader.bundleNameLength, '\0');
+    if (!ReadPatch(&bundleName[0], fileHeader.bundleNameLength) || bundleName.find('\0') != std::string::npos) {
+        HILOG_ERROR(HILOG_MODULE_APP, "patch file bundle name is invalid");
+        return false;
+    }
+    header_.baseVersionCode = fileHeader.baseVersionCode;
+    header_.targetSize = fileHeader.targetSize;
+    header_.targetCrc = fileHeader.targetCrc;
+    header_.bundleName = bundleName;
+    return true;
+}
+
+const HapPatchHeader &HapPatch::GetHeader() const
+{
+    return header_;
+}
+
+bool HapPatch::ReadPatch(void *buffer, uint32_t length)
+{
+    if (length > patchSize_ - readPos_) {
+        return false;
+    }
+    char *dest = static_cast<char *>(buffer);
+    uint32_t readLength = 0;
+    while (readLength < length) {
+        ssize_t readBytes = pread(fd_, dest + readLength, length - readLength,
+            static_cast<off_t>(readPos_ + readLength));
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            return false;
+        }
+        readLength += static_cast<uint32_t>(readBytes);
+    }
+    readPos_ += length;
+    return true;
+}
+
+bool HapPatch::Apply(const std::string &baseDir, const std::string &targetPath)
+{
+    if (fd_ < 0 || header_.bundleName.empty()) {
+        return false;
+    }
+    int32_t targetFd = open(targetPath.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (targetFd < 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "create patch target fail, error: %{public}d", errno);
+        return false;
+    }
+    bool result = WriteTarget(baseDir, targetFd);
+    if (close(targetFd) != 0) {
+        result = false;
+    }
+    if (!result) {
+        unlink(targetPath.c_str());
+    }
+    return result;
+}
+
+bool HapPatch::WriteTarget(const std::string &baseDir, int32_t targetFd)
+{
+    unsigned long crc = crc32(0L, Z_NULL, 0);
+    uint32_t written = 0;
+    PatchSource source;
+    bool result = true;
+    while (result && readPos_ < patchSize_) {
+        uint8_t op = 0;
+        uint32_t length = 0;
+        if (!ReadPatch(&op, sizeof(op))) {
+            result = false;
+        } else if (op == PATCH_OP_INSERT) {
+            uint64_t offset = readPos_ + sizeof(length);
+            result = ReadPatch(&length, sizeof(length)) && length <= header_.targetSize - written &&
+                length <= patchSize_ - offset && CopyRange(fd_, offset, length, targetFd, crc);
+            readPos_ = offset + length;
+        } else if (op == PATCH_OP_COPY) {
+            uint16_t nameLength = 0;
+            uint32_t offset = 0;
+            std::string name;
+            result = ReadPatch(&nameLength, sizeof(nameLength)) && nameLength > 0;
+            if (result) {
+                name.resize(nameLength);
+                result = ReadPatch(&name[0], nameLength) && ReadPatch(&offset, sizeof(offset)) &&
+                    ReadPatch(&length, sizeof(length)) && length <= header_.targetSize - written;
+            }
+            result = result && OpenSource(baseDir, name, source) && offset <= source.size &&
+                length <= source.size - offset && CopyRange(source.fd, offset, length, targetFd, crc);
+        } else {
+            HILOG_ERROR(HILOG_MODULE_APP, "unknown patch op %{public}d", op);
+            result = false;
+        }
+        written += length;
+    }
+    if (source.fd >= 0) {
+        close(source.fd);
+    }
+    if (!result || written != header_.targetSize || crc != header_.targetCrc) {
+        HILOG_ERROR(HILOG_MODULE_APP, "rebuild hap from patch fail");
+        return false;
+    }
+    return true;
+}
+
+bool HapPatch::OpenSource(const std::string &baseDir, const std::string &name, PatchSource &source) const
+{
+    if (source.fd >= 0 && source.name == name) {
+        return true;
+    }
+    if (name.empty() || name.front() == '/' || name.find("..") != std::string::npos ||
+        name.find('\0') != std::string::npos) {
+        HILOG_ERROR(HILOG_MODULE_APP, "patch source name is invalid");
+        return false;
+    }
+    if (source.fd >= 0) {
+        close(source.fd);
+        source.fd = -1;
+    }
+    std::string path = baseDir;
+    if (path.empty() || path.back() != '/') {
+        path += '/';
+    }
+    source.fd = open((path + name).c_str(), O_RDONLY | O_NOFOLLOW);
+    if (source.fd < 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "open patch source fail, error: %{public}d", errno);
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(source.fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        close(source.fd);
+        source.fd = -1;
+        return false;
+    }
+    source.name = name;
+    source.size = static_cast<uint64_t>(fileStat.st_size);
+    return true;
+}
+
+bool HapPatch::CopyRange(int32_t srcFd, uint64_t offset, uint32_t length, int32_t targetFd, unsigned long &crc)
+{
+    if (length == 0) {
+        return true;
+    }
+    std::unique_ptr<Bytef[]> buffer(new (std::nothrow) Bytef[COPY_BUFFER_SIZE]);
+    if (buffer == nullptr) {
+        return false;
+    }
+    uint32_t copied = 0;
+    while (copied < length) {
+        uint32_t size = (length - copied > COPY_BUFFER_SIZE) ? COPY_BUFFER_SIZE : (length - copied);
+        ssize_t readBytes = pread(srcFd, buffer.get(), size, static_cast<off_t>(offset + copied));
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            return false;
+        }
+        ssize_t writeBytes = 0;
+        while (writeBytes < readBytes) {
+            ssize_t len = write(targetFd, buffer.get() + writeBytes, static_cast<size_t>(readBytes - writeBytes));
+            if (len < 0 && errno == EINTR) {
+                continue;
+            }
+            if (len <= 0) {
+                HILOG_ERROR(HILOG_MODULE_APP, "write patch target fail, error: %{public}d", errno);
+                return false;
+            }
+            writeBytes += len;
+        }
+        crc = crc32(crc, buffer.get(), static_cast<uInt>(readBytes));
+        copied += static_cast<uint32_t>(readBytes);
+    }
+    return true;
+}
+} // namespace OHOS
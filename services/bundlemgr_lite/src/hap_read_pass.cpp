@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hap_read_pass.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_read_hint.h"
+#include "log.h"
+
+namespace OHOS {
+namespace {
+// the hap has to stay cached until bundle_daemon has extracted it, leave the rest of the memory to others
+constexpr uint64_t CACHEABLE_MEMORY_DIVISOR = 2;
+}
+
+HapReadPass::HapReadPass(const std::string &hapPath) : hapPath_(hapPath)
+{
+}
+
+static bool IsCacheable(uint64_t size)
+{
+    long pageNum = sysconf(_SC_AVPHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageNum <= 0 || pageSize <= 0) {
+        return false;
+    }
+    return size <= static_cast<uint64_t>(pageNum) * static_cast<uint64_t>(pageSize) / CACHEABLE_MEMORY_DIVISOR;
+}
+
+bool HapReadPass::Run()
+{
+    int32_t fd = open(hapPath_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size > UINT32_MAX ||
+        !IsCacheable(static_cast<uint64_t>(fileStat.st_size))) {
+        HILOG_INFO(HILOG_MODULE_APP, "hap is read by each of its readers!");
+        close(fd);
+        return false;
+    }
+    // the pages are read by the kernel, nothing is copied into this process
+    AdviseFileRead(fd, 0, 0, FILE_READ_HINT_WILLNEED);
+    close(fd);
+    if (!HapVerifyCache::MakeKey(hapPath_, fileKey_)) {
+        return false;
+    }
+    bytesRead_ = static_cast<uint32_t>(fileKey_.size);
+    return true;
+}
+
+uint32_t HapReadPass::GetBytesRead() const
+{
+    return bytesRead_;
+}
+
+const HapFileKey &HapReadPass::GetFileKey() const
+{
+    return fileKey_;
+}
+} // namespace OHOS
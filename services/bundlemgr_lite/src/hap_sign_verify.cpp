@@ -15,18 +15,55 @@
 
 #include "hap_sign_verify.h"
 
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
 #include "appexecfwk_errors.h"
 #include "bundle_manager_service.h"
+#include "file_read_hint.h"
+#include "hap_verify_cache.h"
 #include "log.h"
 
 namespace OHOS {
-uint8_t HapSignVerify::VerifySignature(const std::string &hapFilepath, SignatureInfo &signatureInfo)
+namespace {
+// the signature verifier keeps global state, the batch install workers verify their haps one at a time
+pthread_mutex_t g_verifyMutex = PTHREAD_MUTEX_INITIALIZER;
+
+int32_t AppVerify(const std::string &hapFilepath, VerifyResult &verifyResult)
+{
+    pthread_mutex_lock(&g_verifyMutex);
+    int32_t ret = APPVERI_AppVerify(hapFilepath.c_str(), &verifyResult);
+    pthread_mutex_unlock(&g_verifyMutex);
+    return ret;
+}
+}
+
+uint8_t HapSignVerify::VerifySignature(const std::string &hapFilepath, SignatureInfo &signatureInfo,
+    const HapFileKey *fileKey)
 {
     bool mode = ManagerService::GetInstance().IsDebugMode();
     HILOG_INFO(HILOG_MODULE_APP, "current mode is %d!", mode);
+    HapFileKey key;
+    bool hasKey = (fileKey != nullptr);
+    if (hasKey) {
+        key = *fileKey;
+    } else {
+        hasKey = HapVerifyCache::MakeKey(hapFilepath, key);
+    }
+    if (hasKey && HapVerifyCache::GetInstance().Lookup(key, mode, signatureInfo)) {
+        HILOG_INFO(HILOG_MODULE_APP, "hap is unchanged since it was verified!");
+        return ERR_OK;
+    }
     VerifyResult verifyResult;
+    // the verifier digests the whole hap, get it into the page cache with large reads ahead of time
+    int32_t fd = (fileKey == nullptr) ? open(hapFilepath.c_str(), O_RDONLY) : -1;
+    if (fd >= 0) {
+        AdviseFileRead(fd, 0, 0, FILE_READ_HINT_WILLNEED);
+        close(fd);
+    }
     // verify signature
-    int32_t ret = APPVERI_AppVerify(hapFilepath.c_str(), &verifyResult);
+    int32_t ret = AppVerify(hapFilepath, verifyResult);
     uint8_t errorCode = SwitchErrorCode(ret);
     if (errorCode != ERR_OK) {
         return errorCode;
@@ -39,6 +76,12 @@ uint8_t HapSignVerify::VerifySignature(const std::string &hapFilepath, Signature
         signatureInfo.restrictedPermissions.emplace_back((verifyResult.profile.permission.restricPermission)[i]);
     }
     APPVERI_FreeVerifyRst(&verifyResult);
+    // the hap may have been replaced while it was verified, keep the result only if it was not
+    HapFileKey verifiedKey;
+    if (hasKey && HapVerifyCache::MakeKey(hapFilepath, verifiedKey) &&
+        HapVerifyCache::IsSameKey(key, verifiedKey)) {
+        HapVerifyCache::GetInstance().Store(key, mode, signatureInfo);
+    }
     return ERR_OK;
 }
 
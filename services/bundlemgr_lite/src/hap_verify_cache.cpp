@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hap_verify_cache.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <new>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bundle_common.h"
+#include "bundle_daemon_client.h"
+#include "bundle_util.h"
+#include "cJSON.h"
+#include "log.h"
+#include "zlib.h"
+
+namespace OHOS {
+namespace {
+const char CACHE_DIR[] = "/storage/app/etc";
+const char KEY_VERSION[] = "version";
+const char KEY_CHECKSUM[] = "checksum";
+const char KEY_ENTRIES[] = "entries";
+const char KEY_FILE_ID[] = "fileId";
+const char KEY_KEY[] = "key";
+const char KEY_DEBUG_MODE[] = "debugMode";
+const char KEY_APP_ID[] = "appId";
+const char KEY_PROVISION_BUNDLE_NAME[] = "provisionBundleName";
+const char KEY_RESTRICTED_PERMISSIONS[] = "restrictedPermissions";
+constexpr int32_t CACHE_FORMAT_VERSION = 1;
+constexpr off_t MAX_CACHE_FILE_SIZE = 256 * 1024;
+// the entries text is embedded as a json string, escaping at most doubles it
+constexpr size_t MAX_CACHE_ENTRIES_SIZE = (MAX_CACHE_FILE_SIZE - 1024) / 2;
+constexpr uint32_t PARTIAL_HASH_SIZE = 64 * 1024;
+}
+
+HapVerifyCache::~HapVerifyCache()
+{
+    pthread_mutex_destroy(&mutex_);
+}
+
+static bool HashRange(int32_t fd, uint64_t offset, uint32_t length, unsigned long &crc)
+{
+    if (length == 0) {
+        return true;
+    }
+    std::unique_ptr<Bytef[]> buffer(new (std::nothrow) Bytef[length]);
+    if (buffer == nullptr) {
+        return false;
+    }
+    uint32_t readLength = 0;
+    while (readLength < length) {
+        ssize_t readBytes = pread(fd, buffer.get() + readLength, length - readLength,
+            static_cast<off_t>(offset + readLength));
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            return false;
+        }
+        readLength += static_cast<uint32_t>(readBytes);
+    }
+    crc = crc32(crc, buffer.get(), static_cast<uInt>(length));
+    return true;
+}
+
+void HapVerifyCache::SetKeyStat(const struct stat &fileStat, HapFileKey &key)
+{
+    key.dev = static_cast<uint64_t>(fileStat.st_dev);
+    key.ino = static_cast<uint64_t>(fileStat.st_ino);
+    key.size = static_cast<uint64_t>(fileStat.st_size);
+    key.mtimeSec = fileStat.st_mtim.tv_sec;
+    key.mtimeNsec = fileStat.st_mtim.tv_nsec;
+    key.ctimeSec = fileStat.st_ctim.tv_sec;
+    key.ctimeNsec = fileStat.st_ctim.tv_nsec;
+}
+
+void HapVerifyCache::GetPartialHashRanges(uint64_t size, uint64_t &headLength, uint64_t &tailOffset)
+{
+    headLength = (size > PARTIAL_HASH_SIZE) ? PARTIAL_HASH_SIZE : size;
+    tailOffset = (size - headLength > PARTIAL_HASH_SIZE) ? (size - PARTIAL_HASH_SIZE) : headLength;
+}
+
+bool HapVerifyCache::MakeKey(const std::string &hapPath, HapFileKey &key)
+{
+    int32_t fd = open(hapPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        close(fd);
+        return false;
+    }
+    SetKeyStat(fileStat, key);
+    uint64_t headLength = 0;
+    uint64_t tailOffset = 0;
+    GetPartialHashRanges(key.size, headLength, tailOffset);
+    unsigned long crc = crc32(0L, Z_NULL, 0);
+    bool result = HashRange(fd, 0, static_cast<uint32_t>(headLength), crc) &&
+        HashRange(fd, tailOffset, static_cast<uint32_t>(key.size - tailOffset), crc);
+    close(fd);
+    key.partialHash = static_cast<uint32_t>(crc);
+    return result;
+}
+
+bool HapVerifyCache::IsSameKey(const HapFileKey &key, const HapFileKey &otherKey)
+{
+    return KeyToString(key) == KeyToString(otherKey);
+}
+
+std::string HapVerifyCache::GetFileId(const HapFileKey &key)
+{
+    return std::to_string(key.dev) + ":" + std::to_string(key.ino);
+}
+
+std::string HapVerifyCache::KeyToString(const HapFileKey &key)
+{
+    return GetFileId(key) + ":" + std::to_string(key.size) + ":" + std::to_string(key.mtimeSec) + "." +
+        std::to_string(key.mtimeNsec) + ":" + std::to_string(key.ctimeSec) + "." + std::to_string(key.ctimeNsec) +
+        ":" + std::to_string(key.partialHash);
+}
+
+bool HapVerifyCache::Lookup(const HapFileKey &key, bool debugMode, SignatureInfo &signatureInfo)
+{
+    std::string fileId = GetFileId(key);
+    pthread_mutex_lock(&mutex_);
+    Load();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->fileId != fileId) {
+            continue;
+        }
+        if (it->key == KeyToString(key) && it->debugMode == debugMode) {
+            signatureInfo = it->signatureInfo;
+            pthread_mutex_unlock(&mutex_);
+            return true;
+        }
+        // the file changed since it was verified
+        entries_.erase(it);
+        if (!Save()) {
+            HILOG_WARN(HILOG_MODULE_APP, "save hap verify cache fail!");
+        }
+        break;
+    }
+    pthread_mutex_unlock(&mutex_);
+    return false;
+}
+
+void HapVerifyCache::Store(const HapFileKey &key, bool debugMode, const SignatureInfo &signatureInfo)
+{
+    Entry entry;
+    entry.fileId = GetFileId(key);
+    entry.key = KeyToString(key);
+    entry.debugMode = debugMode;
+    entry.signatureInfo = signatureInfo;
+    pthread_mutex_lock(&mutex_);
+    Load();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->fileId == entry.fileId) {
+            entries_.erase(it);
+            break;
+        }
+    }
+    // the latest first, Save drops the least recently verified haps which do not fit
+    entries_.insert(entries_.begin(), std::move(entry));
+    if (!Save()) {
+        HILOG_WARN(HILOG_MODULE_APP, "save hap verify cache fail!");
+    }
+    pthread_mutex_unlock(&mutex_);
+}
+
+bool HapVerifyCache::ReadCacheFile(std::string &content)
+{
+    int32_t fd = open(HAP_VERIFY_CACHE_JSON, O_RDONLY | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    }
+    // only bundle_daemon writes the cache, anything else may have changed it
+    struct stat dirStat;
+    struct stat fileStat;
+    if (stat(CACHE_DIR, &dirStat) != 0 || fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) ||
+        fileStat.st_uid != dirStat.st_uid || (fileStat.st_mode & (S_IWGRP | S_IWOTH)) != 0 ||
+        (dirStat.st_mode & (S_IWGRP | S_IWOTH)) != 0 || fileStat.st_size <= 0 ||
+        fileStat.st_size > MAX_CACHE_FILE_SIZE) {
+        HILOG_WARN(HILOG_MODULE_APP, "hap verify cache is not owned by bundle_daemon!");
+        close(fd);
+        return false;
+    }
+    content.resize(static_cast<size_t>(fileStat.st_size));
+    size_t readLength = 0;
+    while (readLength < content.size()) {
+        ssize_t readBytes = read(fd, &content[readLength], content.size() - readLength);
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            close(fd);
+            return false;
+        }
+        readLength += static_cast<size_t>(readBytes);
+    }
+    close(fd);
+    return true;
+}
+
+static bool ParseEntry(const cJSON *item, std::string &fileId, std::string &key, bool &debugMode,
+    SignatureInfo &signatureInfo)
+{
+    const cJSON *fileIdItem = cJSON_GetObjectItem(item, KEY_FILE_ID);
+    const cJSON *keyItem = cJSON_GetObjectItem(item, KEY_KEY);
+    const cJSON *debugModeItem = cJSON_GetObjectItem(item, KEY_DEBUG_MODE);
+    const cJSON *appIdItem = cJSON_GetObjectItem(item, KEY_APP_ID);
+    const cJSON *bundleNameItem = cJSON_GetObjectItem(item, KEY_PROVISION_BUNDLE_NAME);
+    const cJSON *permissionsItem = cJSON_GetObjectItem(item, KEY_RESTRICTED_PERMISSIONS);
+    if (!cJSON_IsString(fileIdItem) || !cJSON_IsString(keyItem) || !cJSON_IsBool(debugModeItem) ||
+        !cJSON_IsString(appIdItem) || !cJSON_IsString(bundleNameItem) || !cJSON_IsArray(permissionsItem)) {
+        return false;
+    }
+    fileId = fileIdItem->valuestring;
+    key = keyItem->valuestring;
+    debugMode = cJSON_IsTrue(debugModeItem);
+    signatureInfo.appId = appIdItem->valuestring;
+    signatureInfo.provisionBundleName = bundleNameItem->valuestring;
+    const cJSON *permission = nullptr;
+    cJSON_ArrayForEach(permission, permissionsItem) {
+        if (!cJSON_IsString(permission)) {
+            return false;
+        }
+        signatureInfo.restrictedPermissions.emplace_back(permission->valuestring);
+    }
+    return true;
+}
+
+void HapVerifyCache::Load()
+{
+    if (loaded_) {
+        return;
+    }
+    loaded_ = true;
+    std::string content;
+    if (!ReadCacheFile(content)) {
+        return;
+    }
+    // the entries are kept as text, so that the checksum covers exactly what was written
+    cJSON *root = cJSON_Parse(content.c_str());
+    const cJSON *version = cJSON_GetObjectItem(root, KEY_VERSION);
+    const cJSON *checksum = cJSON_GetObjectItem(root, KEY_CHECKSUM);
+    const cJSON *entriesText = cJSON_GetObjectItem(root, KEY_ENTRIES);
+    cJSON *entries = nullptr;
+    if (cJSON_IsNumber(version) && version->valueint == CACHE_FORMAT_VERSION && cJSON_IsNumber(checksum) &&
+        cJSON_IsString(entriesText) && static_cast<double>(crc32(crc32(0L, Z_NULL, 0),
+        reinterpret_cast<const Bytef *>(entriesText->valuestring), strlen(entriesText->valuestring))) ==
+        checksum->valuedouble) {
+        entries = cJSON_Parse(entriesText->valuestring);
+    }
+    cJSON_Delete(root);
+    bool result = cJSON_IsArray(entries);
+    const cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, entries) {
+        Entry entry;
+        if (!ParseEntry(item, entry.fileId, entry.key, entry.debugMode, entry.signatureInfo)) {
+            result = false;
+            break;
+        }
+        entries_.emplace_back(std::move(entry));
+    }
+    cJSON_Delete(entries);
+    if (!result) {
+        HILOG_WARN(HILOG_MODULE_APP, "hap verify cache is corrupted, drop it!");
+        entries_.clear();
+        BundleDaemonClient::GetInstance().RemoveFile(HAP_VERIFY_CACHE_JSON);
+    }
+}
+
+static cJSON *ConvertEntryToJson(const std::string &fileId, const std::string &key, bool debugMode,
+    const SignatureInfo &signatureInfo)
+{
+    cJSON *item = cJSON_CreateObject();
+    if (item == nullptr) {
+        return nullptr;
+    }
+    cJSON *permissions = cJSON_AddArrayToObject(item, KEY_RESTRICTED_PERMISSIONS);
+    if (permissions == nullptr || cJSON_AddStringToObject(item, KEY_FILE_ID, fileId.c_str()) == nullptr ||
+        cJSON_AddStringToObject(item, KEY_KEY, key.c_str()) == nullptr ||
+        cJSON_AddBoolToObject(item, KEY_DEBUG_MODE, debugMode) == nullptr ||
+        cJSON_AddStringToObject(item, KEY_APP_ID, signatureInfo.appId.c_str()) == nullptr ||
+        cJSON_AddStringToObject(item, KEY_PROVISION_BUNDLE_NAME, signatureInfo.provisionBundleName.c_str()) ==
+        nullptr) {
+        cJSON_Delete(item);
+        return nullptr;
+    }
+    for (const auto &permission : signatureInfo.restrictedPermissions) {
+        cJSON *permissionItem = cJSON_CreateString(permission.c_str());
+        if (permissionItem == nullptr) {
+            cJSON_Delete(item);
+            return nullptr;
+        }
+        cJSON_AddItemToArray(permissions, permissionItem);
+    }
+    return item;
+}
+
+bool HapVerifyCache::Save()
+{
+    // the array is joined by hand, so that the entries which do not fit are dropped before anything is written
+    std::string entriesText = "[";
+    size_t count = 0;
+    for (; count < entries_.size(); ++count) {
+        const Entry &entry = entries_[count];
+        cJSON *item = ConvertEntryToJson(entry.fileId, entry.key, entry.debugMode, entry.signatureInfo);
+        if (item == nullptr) {
+            return false;
+        }
+        char *itemText = cJSON_PrintUnformatted(item);
+        cJSON_Delete(item);
+        if (itemText == nullptr) {
+            return false;
+        }
+        size_t itemLength = strlen(itemText);
+        if (entriesText.size() + itemLength + 2 > MAX_CACHE_ENTRIES_SIZE) {
+            cJSON_free(itemText);
+            break;
+        }
+        if (count != 0) {
+            entriesText += ",";
+        }
+        entriesText.append(itemText, itemLength);
+        cJSON_free(itemText);
+    }
+    entriesText += "]";
+    entries_.resize(count);
+    uLong checksum = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(entriesText.c_str()),
+        entriesText.size());
+    cJSON *root = cJSON_CreateObject();
+    if (root == nullptr || cJSON_AddNumberToObject(root, KEY_VERSION, CACHE_FORMAT_VERSION) == nullptr ||
+        cJSON_AddNumberToObject(root, KEY_CHECKSUM, checksum) == nullptr ||
+        cJSON_AddStringToObject(root, KEY_ENTRIES, entriesText.c_str()) == nullptr) {
+        cJSON_Delete(root);
+        return false;
+    }
+    char *buffer = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (buffer == nullptr) {
+        return false;
+    }
+    // the cache outgrows a single daemon request, it goes in chunks
+    std::string content(buffer);
+    cJSON_free(buffer);
+    if (content.size() > static_cast<size_t>(MAX_CACHE_FILE_SIZE)) {
+        return false;
+    }
+    return BundleUtil::StoreContentInChunks(HAP_VERIFY_CACHE_JSON, content);
+}
+} // namespace OHOS
@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "install_journal.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <set>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bundle_daemon_client.h"
+#include "bundle_util.h"
+#include "install_record_store.h"
+#include "log.h"
+#include "securec.h"
+#include "zlib.h"
+
+namespace OHOS {
+namespace {
+const char KEY_OPERATIONS[] = "operations";
+const char KEY_OPERATION_TYPE[] = "type";
+const char KEY_RECORD[] = "record";
+const char OPERATION_PUT[] = "put";
+const char OPERATION_REMOVE[] = "remove";
+const char OPERATION_THIRD_SYSTEM[] = "thirdSystem";
+const char OPERATION_UNINSTALLED_THIRD_SYSTEM[] = "uninstalledThirdSystem";
+// a line is the crc-32 of the transaction in hex, a space, the transaction in json and a line feed
+constexpr uint32_t CRC_TEXT_LEN = 8;
+constexpr int32_t HEX_BASE = 16;
+// the group of transactions which are appended together has to fit into one ipc to bundle_daemon
+constexpr uint32_t MAX_APPEND_SIZE = 4 * 1024;
+constexpr uint32_t MAX_JOURNAL_SIZE = 16 * 1024;
+constexpr off_t MAX_JOURNAL_READ_SIZE = 1024 * 1024;
+}
+
+InstallJournal::~InstallJournal()
+{
+    pthread_cond_destroy(&cond_);
+    pthread_mutex_destroy(&mutex_);
+}
+
+static bool ReadJournal(std::string &content)
+{
+    int32_t fd = open(INSTALL_JOURNAL_PATH, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size > MAX_JOURNAL_READ_SIZE) {
+        close(fd);
+        return false;
+    }
+    content.resize(static_cast<size_t>(fileStat.st_size));
+    size_t readLength = 0;
+    while (readLength < content.size()) {
+        ssize_t readBytes = read(fd, &content[readLength], content.size() - readLength);
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            break;
+        }
+        readLength += static_cast<size_t>(readBytes);
+    }
+    close(fd);
+    content.resize(readLength);
+    return true;
+}
+
+static uint32_t GetCrc(const char *text, size_t length)
+{
+    return static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(text),
+        static_cast<uInt>(length)));
+}
+
+static bool IsValidBundleName(const char *bundleName)
+{
+    size_t length = (bundleName == nullptr) ? 0 : strlen(bundleName);
+    return length > 0 && length <= MAX_BUNDLE_NAME_LEN && strchr(bundleName, PATH_SEPARATOR[0]) == nullptr &&
+        strcmp(bundleName, ".") != 0 && strcmp(bundleName, "..") != 0;
+}
+
+static const char *GetOperationBundleName(const cJSON *operation)
+{
+    const cJSON *type = cJSON_GetObjectItemCaseSensitive(operation, KEY_OPERATION_TYPE);
+    if (!cJSON_IsString(type)) {
+        return nullptr;
+    }
+    const cJSON *bundleName = nullptr;
+    if (strcmp(type->valuestring, OPERATION_PUT) == 0) {
+        const cJSON *record = cJSON_GetObjectItemCaseSensitive(operation, KEY_RECORD);
+        if (!cJSON_IsNumber(cJSON_GetObjectItemCaseSensitive(record, JSON_SUB_KEY_UID)) ||
+            !cJSON_IsNumber(cJSON_GetObjectItemCaseSensitive(record, JSON_SUB_KEY_GID))) {
+            return nullptr;
+        }
+        bundleName = cJSON_GetObjectItemCaseSensitive(record, JSON_SUB_KEY_PACKAGE);
+    } else if (strcmp(type->valuestring, OPERATION_REMOVE) == 0 ||
+        strcmp(type->valuestring, OPERATION_THIRD_SYSTEM) == 0 ||
+        strcmp(type->valuestring, OPERATION_UNINSTALLED_THIRD_SYSTEM) == 0) {
+        bundleName = cJSON_GetObjectItemCaseSensitive(operation, JSON_SUB_KEY_PACKAGE);
+    }
+    if (!cJSON_IsString(bundleName) || !IsValidBundleName(bundleName->valuestring)) {
+        return nullptr;
+    }
+    return bundleName->valuestring;
+}
+
+// what the replayed transactions changed
+struct JournalChanges {
+    // the latest record of each bundle the journal touched, nullptr for a removed bundle
+    std::map<std::string, cJSON *> records;
+    std::set<std::string> thirdSystemBundles;
+    std::set<std::string> uninstalledThirdSystemBundles;
+};
+
+static void SetRecord(std::map<std::string, cJSON *> &records, const char *bundleName, cJSON *record)
+{
+    auto it = records.find(bundleName);
+    if (it != records.end()) {
+        cJSON_Delete(it->second);
+        it->second = record;
+        return;
+    }
+    records.emplace(bundleName, record);
+}
+
+static bool ReplayTransaction(const std::string &line, JournalChanges &changes)
+{
+    if (line.size() <= CRC_TEXT_LEN + 1 || line[CRC_TEXT_LEN] != ' ') {
+        return false;
+    }
+    char *end = nullptr;
+    uint32_t crc = static_cast<uint32_t>(strtoul(line.substr(0, CRC_TEXT_LEN).c_str(), &end, HEX_BASE));
+    const char *text = line.c_str() + CRC_TEXT_LEN + 1;
+    if (end == nullptr || *end != '\0' || crc != GetCrc(text, line.size() - CRC_TEXT_LEN - 1)) {
+        return false;
+    }
+    cJSON *root = cJSON_Parse(text);
+    const cJSON *operations = cJSON_GetObjectItemCaseSensitive(root, KEY_OPERATIONS);
+    if (!cJSON_IsArray(operations)) {
+        cJSON_Delete(root);
+        return false;
+    }
+    // a transaction is replayed as a whole or not at all
+    const cJSON *operation = nullptr;
+    cJSON_ArrayForEach(operation, operations) {
+        if (GetOperationBundleName(operation) == nullptr) {
+            cJSON_Delete(root);
+            return false;
+        }
+    }
+    cJSON_ArrayForEach(operation, operations) {
+        const char *bundleName = GetOperationBundleName(operation);
+        const char *type = cJSON_GetObjectItemCaseSensitive(operation, KEY_OPERATION_TYPE)->valuestring;
+        if (strcmp(type, OPERATION_THIRD_SYSTEM) == 0) {
+            changes.thirdSystemBundles.insert(bundleName);
+        } else if (strcmp(type, OPERATION_UNINSTALLED_THIRD_SYSTEM) == 0) {
+            changes.uninstalledThirdSystemBundles.insert(bundleName);
+        } else {
+            const cJSON *record = cJSON_GetObjectItemCaseSensitive(operation, KEY_RECORD);
+            SetRecord(changes.records, bundleName, (record == nullptr) ? nullptr : cJSON_Duplicate(record, true));
+        }
+    }
+    cJSON_Delete(root);
+    return true;
+}
+
+static const char *GetRecordString(const cJSON *record, const char *key)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(record, key);
+    return cJSON_IsString(item) ? item->valuestring : nullptr;
+}
+
+static bool StoreChanges(const JournalChanges &changes)
+{
+    InstallRecordBatch batch;
+    for (const auto &it : changes.records) {
+        if (it.second == nullptr) {
+            batch.RemoveRecord(it.first);
+            continue;
+        }
+        const cJSON *versionCode = cJSON_GetObjectItemCaseSensitive(it.second, JSON_SUB_KEY_VERSIONCODE);
+        InstallRecord installRecord = {
+            .bundleName = const_cast<char *>(it.first.c_str()),
+            .codePath = const_cast<char *>(GetRecordString(it.second, JSON_SUB_KEY_CODEPATH)),
+            .appId = const_cast<char *>(GetRecordString(it.second, JSON_SUB_KEY_APPID)),
+            .versionCode = cJSON_IsNumber(versionCode) ? versionCode->valueint : -1,
+            .uid = cJSON_GetObjectItemCaseSensitive(it.second, JSON_SUB_KEY_UID)->valueint,
+            .gid = cJSON_GetObjectItemCaseSensitive(it.second, JSON_SUB_KEY_GID)->valueint
+        };
+        batch.PutRecord(installRecord);
+    }
+    for (const auto &bundleName : changes.thirdSystemBundles) {
+        batch.AddThirdSystemBundle(bundleName);
+    }
+    for (const auto &bundleName : changes.uninstalledThirdSystemBundles) {
+        batch.AddUninstalledThirdSystemBundle(bundleName);
+    }
+    // the whole checkpoint is one batch of the install record store
+    return InstallRecordStore::GetInstance().Apply(batch);
+}
+
+void InstallJournal::Recover()
+{
+    pthread_mutex_lock(&mutex_);
+    while (busy_) {
+        pthread_cond_wait(&cond_, &mutex_);
+    }
+    busy_ = true;
+    pthread_mutex_unlock(&mutex_);
+    if (!Checkpoint()) {
+        HILOG_ERROR(HILOG_MODULE_APP, "checkpoint install journal fail, it is kept for the next boot!");
+    }
+    pthread_mutex_lock(&mutex_);
+    busy_ = false;
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+bool InstallJournal::Checkpoint()
+{
+    std::string content;
+    if (!ReadJournal(content)) {
+        journalSize_ = 0;
+        return true;
+    }
+    JournalChanges changes;
+    size_t committedSize = 0;
+    uint32_t transactionNum = 0;
+    while (committedSize < content.size()) {
+        size_t end = content.find('\n', committedSize);
+        if (end == std::string::npos ||
+            !ReplayTransaction(content.substr(committedSize, end - committedSize), changes)) {
+            break;
+        }
+        committedSize = end + 1;
+        transactionNum++;
+    }
+    if (committedSize < content.size()) {
+        HILOG_WARN(HILOG_MODULE_APP, "install journal has a torn tail of %{public}zu bytes, roll it back!",
+            content.size() - committedSize);
+    }
+    bool result = StoreChanges(changes);
+    for (auto &it : changes.records) {
+        cJSON_Delete(it.second);
+    }
+    pthread_mutex_lock(&mutex_);
+    if (result) {
+        thirdSystemBundles_.clear();
+    } else {
+        // they are still only in the journal
+        thirdSystemBundles_.insert(changes.thirdSystemBundles.begin(), changes.thirdSystemBundles.end());
+    }
+    pthread_mutex_unlock(&mutex_);
+    HILOG_INFO(HILOG_MODULE_APP, "checkpoint %{public}u install transactions, result is %{public}d",
+        transactionNum, result);
+    if (result) {
+        result = BundleDaemonClient::GetInstance().RemoveFile(INSTALL_JOURNAL_PATH) == EC_SUCCESS;
+        journalSize_ = 0;
+        return result;
+    }
+    // later appends must not follow the torn tail, or they would be rolled back with it
+    if (committedSize < content.size()) {
+        content.resize(committedSize);
+        if (content.empty()) {
+            (void) BundleDaemonClient::GetInstance().RemoveFile(INSTALL_JOURNAL_PATH);
+        } else {
+            (void) BundleDaemonClient::GetInstance().StoreContentToFile(INSTALL_JOURNAL_PATH, content.c_str(),
+                content.size());
+        }
+    }
+    journalSize_ = static_cast<uint32_t>(content.size());
+    return false;
+}
+
+static bool AddNameOperation(cJSON *operations, const char *type, const char *bundleName)
+{
+    cJSON *operation = cJSON_CreateObject();
+    if (operation == nullptr || !cJSON_AddItemToArray(operations, operation)) {
+        cJSON_Delete(operation);
+        return false;
+    }
+    return cJSON_AddStringToObject(operation, KEY_OPERATION_TYPE, type) != nullptr &&
+        cJSON_AddStringToObject(operation, JSON_SUB_KEY_PACKAGE, bundleName) != nullptr;
+}
+
+static bool AddInstallOperations(cJSON *operations, const InstallRecord &installRecord, uint8_t hapType)
+{
+    cJSON *operation = cJSON_CreateObject();
+    cJSON *record = BundleUtil::ConvertInstallRecordToJson(installRecord);
+    if (operation == nullptr || record == nullptr || !cJSON_AddItemToArray(operations, operation)) {
+        cJSON_Delete(operation);
+        cJSON_Delete(record);
+        return false;
+    }
+    if (cJSON_AddStringToObject(operation, KEY_OPERATION_TYPE, OPERATION_PUT) == nullptr ||
+        !cJSON_AddItemToObject(operation, KEY_RECORD, record)) {
+        cJSON_Delete(record);
+        return false;
+    }
+    return hapType != THIRD_SYSTEM_APP_FLAG ||
+        AddNameOperation(operations, OPERATION_THIRD_SYSTEM, installRecord.bundleName);
+}
+
+uint32_t InstallJournal::GetInstallCommitNum(const InstallRecord *records, const uint8_t *hapTypes, uint32_t num)
+{
+    if (records == nullptr || hapTypes == nullptr) {
+        return 0;
+    }
+    // the crc, the space, {"operations":[ and ]} and the line feed
+    size_t lineSize = CRC_TEXT_LEN + 1 + strlen(KEY_OPERATIONS) + strlen("{\"\":[]}") + 1;
+    for (uint32_t i = 0; i < num; i++) {
+        cJSON *operations = cJSON_CreateArray();
+        if (operations == nullptr || !AddInstallOperations(operations, records[i], hapTypes[i])) {
+            cJSON_Delete(operations);
+            return i;
+        }
+        char *text = cJSON_PrintUnformatted(operations);
+        cJSON_Delete(operations);
+        if (text == nullptr) {
+            return i;
+        }
+        // without the brackets of the array, with the comma which joins it to the operations before
+        lineSize += strlen(text) - 2 + ((i == 0) ? 0 : 1);
+        cJSON_free(text);
+        if (lineSize > MAX_APPEND_SIZE) {
+            return i;
+        }
+    }
+    return num;
+}
+
+bool InstallJournal::CommitInstall(const InstallRecord *records, const uint8_t *hapTypes, uint32_t num)
+{
+    if (records == nullptr || hapTypes == nullptr || num == 0) {
+        return false;
+    }
+    cJSON *operations = cJSON_CreateArray();
+    if (operations == nullptr) {
+        return false;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        if (!AddInstallOperations(operations, records[i], hapTypes[i])) {
+            cJSON_Delete(operations);
+            return false;
+        }
+    }
+    if (!Commit(operations)) {
+        return false;
+    }
+    pthread_mutex_lock(&mutex_);
+    for (uint32_t i = 0; i < num; i++) {
+        if (hapTypes[i] == THIRD_SYSTEM_APP_FLAG) {
+            thirdSystemBundles_.insert(records[i].bundleName);
+        }
+    }
+    pthread_mutex_unlock(&mutex_);
+    return true;
+}
+
+bool InstallJournal::CommitUninstall(const char *bundleName, bool isThirdSystem)
+{
+    if (!IsValidBundleName(bundleName)) {
+        return false;
+    }
+    cJSON *operations = cJSON_CreateArray();
+    if (operations == nullptr) {
+        return false;
+    }
+    if (!AddNameOperation(operations, OPERATION_REMOVE, bundleName) || (isThirdSystem &&
+        !AddNameOperation(operations, OPERATION_UNINSTALLED_THIRD_SYSTEM, bundleName))) {
+        cJSON_Delete(operations);
+        return false;
+    }
+    return Commit(operations);
+}
+
+bool InstallJournal::IsThirdSystemBundle(const char *bundleName)
+{
+    if (bundleName == nullptr) {
+        return false;
+    }
+    pthread_mutex_lock(&mutex_);
+    bool result = thirdSystemBundles_.count(bundleName) != 0;
+    pthread_mutex_unlock(&mutex_);
+    return result || InstallRecordStore::GetInstance().IsThirdSystemBundle(bundleName);
+}
+
+bool InstallJournal::Commit(cJSON *operations)
+{
+    cJSON *root = cJSON_CreateObject();
+    if (root == nullptr || !cJSON_AddItemToObject(root, KEY_OPERATIONS, operations)) {
+        cJSON_Delete(operations);
+        cJSON_Delete(root);
+        return false;
+    }
+    char *text = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (text == nullptr) {
+        return false;
+    }
+    char crcText[CRC_TEXT_LEN + 1] = { 0 };
+    if (sprintf_s(crcText, sizeof(crcText), "%08x", GetCrc(text, strlen(text))) < 0) {
+        cJSON_free(text);
+        return false;
+    }
+    Transaction transaction;
+    transaction.line = std::string(crcText) + " " + text + "\n";
+    cJSON_free(text);
+    if (transaction.line.size() > MAX_APPEND_SIZE) {
+        HILOG_ERROR(HILOG_MODULE_APP, "install transaction of %{public}zu bytes is too large!",
+            transaction.line.size());
+        return false;
+    }
+
+    // the first committer which finds the journal idle appends the transactions of everyone waiting
+    pthread_mutex_lock(&mutex_);
+    pending_.push_back(&transaction);
+    while (!transaction.done) {
+        if (busy_) {
+            pthread_cond_wait(&cond_, &mutex_);
+            continue;
+        }
+        FlushPending();
+    }
+    pthread_mutex_unlock(&mutex_);
+    if (!transaction.result) {
+        HILOG_ERROR(HILOG_MODULE_APP, "append install journal fail!");
+        return false;
+    }
+    CheckpointIfFull();
+    return true;
+}
+
+void InstallJournal::FlushPending()
+{
+    // called with mutex_ held, which is released while bundle_daemon appends
+    busy_ = true;
+    std::vector<Transaction *> group;
+    std::string buffer;
+    // every line fits on its own, Commit rejects the larger ones
+    while (!pending_.empty() && buffer.size() + pending_.front()->line.size() <= MAX_APPEND_SIZE) {
+        buffer += pending_.front()->line;
+        group.push_back(pending_.front());
+        pending_.pop_front();
+    }
+    pthread_mutex_unlock(&mutex_);
+    bool result = BundleDaemonClient::GetInstance().AppendContentToFile(INSTALL_JOURNAL_PATH, buffer.c_str(),
+        static_cast<uint32_t>(buffer.size()), true) == EC_SUCCESS;
+    pthread_mutex_lock(&mutex_);
+    if (result) {
+        journalSize_ += static_cast<uint32_t>(buffer.size());
+    }
+    for (auto transaction : group) {
+        transaction->result = result;
+        transaction->done = true;
+    }
+    busy_ = false;
+    pthread_cond_broadcast(&cond_);
+}
+
+void InstallJournal::CheckpointIfFull()
+{
+    pthread_mutex_lock(&mutex_);
+    while (busy_) {
+        pthread_cond_wait(&cond_, &mutex_);
+    }
+    if (journalSize_ < MAX_JOURNAL_SIZE) {
+        pthread_mutex_unlock(&mutex_);
+        return;
+    }
+    busy_ = true;
+    pthread_mutex_unlock(&mutex_);
+    (void) Checkpoint();
+    pthread_mutex_lock(&mutex_);
+    busy_ = false;
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+}
+} // namespace OHOS
@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "install_record_store.h"
+
+#include <cstring>
+#include <dirent.h>
+
+#include "bundle_daemon_client.h"
+#include "bundle_util.h"
+#include "cJSON.h"
+#include "log.h"
+#include "text_record_codec.h"
+
+namespace OHOS {
+namespace {
+const char STORE_MAGIC[] = "BMSI";
+constexpr int64_t STORE_FORMAT_VERSION = 1;
+constexpr off_t MAX_STORE_FILE_SIZE = 4 * 1024 * 1024;
+// the store as it was before the last batch, read when the store itself is corrupted
+const char BAK_FILE_SUFFIX[] = ".bak";
+// a corrupted store is kept here for inspection rather than removed
+const char CORRUPT_FILE_SUFFIX[] = ".corrupt";
+}
+
+void InstallRecordBatch::PutRecord(const InstallRecord &record)
+{
+    Change change = { PUT_RECORD, (record.bundleName == nullptr) ? "" : record.bundleName, StoredRecord() };
+    change.record.codePath = (record.codePath == nullptr) ? "" : record.codePath;
+    change.record.appId = (record.appId == nullptr) ? "" : record.appId;
+    change.record.versionCode = record.versionCode;
+    change.record.uid = record.uid;
+    change.record.gid = record.gid;
+    changes_.push_back(std::move(change));
+}
+
+void InstallRecordBatch::RemoveRecord(const std::string &bundleName)
+{
+    changes_.push_back({ REMOVE_RECORD, bundleName, StoredRecord() });
+}
+
+void InstallRecordBatch::ReleaseUid(const std::string &bundleName)
+{
+    changes_.push_back({ RELEASE_UID, bundleName, StoredRecord() });
+}
+
+void InstallRecordBatch::AddThirdSystemBundle(const std::string &bundleName)
+{
+    changes_.push_back({ ADD_THIRD_SYSTEM_BUNDLE, bundleName, StoredRecord() });
+}
+
+void InstallRecordBatch::AddUninstalledThirdSystemBundle(const std::string &bundleName)
+{
+    changes_.push_back({ ADD_UNINSTALLED_THIRD_SYSTEM_BUNDLE, bundleName, StoredRecord() });
+}
+
+InstallRecordStore::~InstallRecordStore()
+{
+    pthread_mutex_destroy(&mutex_);
+}
+
+static void PutBundleNames(TextRecordWriter &writer, const std::set<std::string> &bundleNames)
+{
+    writer.PutInt(static_cast<int64_t>(bundleNames.size()));
+    for (const auto &bundleName : bundleNames) {
+        writer.PutString(bundleName);
+    }
+}
+
+static bool GetBundleNames(TextRecordReader &reader, std::set<std::string> &bundleNames)
+{
+    int64_t num = 0;
+    if (!reader.GetInt(num) || num < 0) {
+        return false;
+    }
+    for (int64_t i = 0; i < num; i++) {
+        std::string bundleName;
+        if (!reader.GetString(bundleName)) {
+            return false;
+        }
+        bundleNames.insert(std::move(bundleName));
+    }
+    return true;
+}
+
+std::string InstallRecordStore::SerializeTables(const Tables &tables)
+{
+    std::string payload;
+    TextRecordWriter writer(payload);
+    writer.PutInt(static_cast<int64_t>(tables.nextSerial));
+    writer.PutInt(static_cast<int64_t>(tables.records.size()));
+    for (const auto &it : tables.records) {
+        writer.PutString(it.first);
+        writer.PutInt(static_cast<int64_t>(it.second.serial));
+        writer.PutInt(it.second.versionCode);
+        writer.PutInt(it.second.uid);
+        writer.PutInt(it.second.gid);
+        writer.PutString(it.second.codePath);
+        writer.PutString(it.second.appId);
+    }
+    writer.PutInt(static_cast<int64_t>(tables.uids.size()));
+    for (const auto &it : tables.uids) {
+        writer.PutString(it.first);
+        writer.PutInt(it.second.uid);
+        writer.PutInt(it.second.gid);
+    }
+    PutBundleNames(writer, tables.thirdSystemBundles);
+    PutBundleNames(writer, tables.uninstalledThirdSystemBundles);
+    return TextRecordFile::Seal(STORE_MAGIC, STORE_FORMAT_VERSION, payload);
+}
+
+bool InstallRecordStore::ParseTables(const std::string &content, size_t offset, Tables &tables)
+{
+    TextRecordReader reader(content, offset, content.size() - offset);
+    int64_t recordNum = 0;
+    if (!reader.GetInt(tables.nextSerial) || !reader.GetInt(recordNum) || recordNum < 0) {
+        return false;
+    }
+    for (int64_t i = 0; i < recordNum; i++) {
+        std::string bundleName;
+        StoredRecord record;
+        if (!reader.GetString(bundleName) || !reader.GetInt(record.serial) || !reader.GetInt(record.versionCode) ||
+            !reader.GetInt(record.uid) || !reader.GetInt(record.gid) || !reader.GetString(record.codePath) ||
+            !reader.GetString(record.appId)) {
+            return false;
+        }
+        tables.records[bundleName] = std::move(record);
+    }
+    int64_t uidNum = 0;
+    if (!reader.GetInt(uidNum) || uidNum < 0) {
+        return false;
+    }
+    for (int64_t i = 0; i < uidNum; i++) {
+        std::string bundleName;
+        UidEntry entry;
+        if (!reader.GetString(bundleName) || !reader.GetInt(entry.uid) || !reader.GetInt(entry.gid)) {
+            return false;
+        }
+        tables.uids[bundleName] = entry;
+    }
+    return GetBundleNames(reader, tables.thirdSystemBundles) &&
+        GetBundleNames(reader, tables.uninstalledThirdSystemBundles) && reader.GetPos() == content.size();
+}
+
+bool InstallRecordStore::ReadStoreFile(const char *path, Tables &tables)
+{
+    std::string content;
+    size_t offset = 0;
+    if (!TextRecordFile::Read(path, MAX_STORE_FILE_SIZE, content) ||
+        !TextRecordFile::Unseal(content, STORE_MAGIC, STORE_FORMAT_VERSION, offset)) {
+        return false;
+    }
+    Tables readTables;
+    if (!ParseTables(content, offset, readTables)) {
+        return false;
+    }
+    tables = std::move(readTables);
+    return true;
+}
+
+static const char *GetJsonString(const cJSON *object, const char *key)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(object, key);
+    return cJSON_IsString(item) ? item->valuestring : nullptr;
+}
+
+static int32_t GetJsonNumber(const cJSON *object, const char *key, int32_t defaultValue)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(object, key);
+    return cJSON_IsNumber(item) ? item->valueint : defaultValue;
+}
+
+void InstallRecordStore::MigrateRecordJsons(Tables &tables)
+{
+    DIR *dir = opendir(JSON_PATH);
+    if (dir == nullptr) {
+        return;
+    }
+    std::string uidMapName = std::string(UID_GID_MAP) + JSON_SUFFIX;
+    struct dirent *ent = nullptr;
+    while ((ent = readdir(dir)) != nullptr) {
+        std::string fileName = ent->d_name;
+        if (fileName == uidMapName || !BundleUtil::EndWith(fileName.c_str(), JSON_SUFFIX)) {
+            continue;
+        }
+        std::string bundleName = fileName.substr(0, fileName.size() - strlen(JSON_SUFFIX));
+        cJSON *object = BundleUtil::GetJsonStream((std::string(JSON_PATH) + fileName).c_str());
+        const char *package = GetJsonString(object, JSON_SUB_KEY_PACKAGE);
+        const char *codePath = GetJsonString(object, JSON_SUB_KEY_CODEPATH);
+        const char *appId = GetJsonString(object, JSON_SUB_KEY_APPID);
+        const cJSON *versionCode = cJSON_GetObjectItemCaseSensitive(object, JSON_SUB_KEY_VERSIONCODE);
+        // a record json left behind by a failed install is not named after its bundle
+        if (package == nullptr || bundleName != package || codePath == nullptr || appId == nullptr ||
+            !cJSON_IsNumber(versionCode)) {
+            cJSON_Delete(object);
+            continue;
+        }
+        StoredRecord record;
+        record.codePath = codePath;
+        record.appId = appId;
+        record.versionCode = versionCode->valueint;
+        record.uid = GetJsonNumber(object, JSON_SUB_KEY_UID, INVALID_UID);
+        record.gid = GetJsonNumber(object, JSON_SUB_KEY_GID, INVALID_GID);
+        record.serial = tables.nextSerial++;
+        tables.records[bundleName] = std::move(record);
+        cJSON_Delete(object);
+    }
+    closedir(dir);
+}
+
+void InstallRecordStore::MigrateUidMap(Tables &tables)
+{
+    std::string uidJsonPath = std::string(JSON_PATH) + UID_GID_MAP + JSON_SUFFIX;
+    cJSON *object = BundleUtil::GetJsonStream(uidJsonPath.c_str());
+    const cJSON *uids = cJSON_GetObjectItemCaseSensitive(object, PROFILE_KEY_UID_AND_GID);
+    const cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, uids) {
+        const char *bundleName = GetJsonString(item, JSON_SUB_KEY_PACKAGE);
+        int32_t uid = GetJsonNumber(item, JSON_SUB_KEY_UID, INVALID_UID);
+        if (bundleName == nullptr || uid == INVALID_UID) {
+            continue;
+        }
+        UidEntry entry;
+        entry.uid = uid;
+        entry.gid = GetJsonNumber(item, JSON_SUB_KEY_GID, uid);
+        tables.uids[bundleName] = entry;
+    }
+    cJSON_Delete(object);
+}
+
+void InstallRecordStore::MigrateBundleList(const char *path, std::set<std::string> &bundleNames)
+{
+    cJSON *object = BundleUtil::GetJsonStream(path);
+    const cJSON *array = cJSON_GetObjectItem(object, JSON_MAIN_KEY);
+    const cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, array) {
+        if (cJSON_IsString(item) && item->valuestring != nullptr) {
+            bundleNames.insert(item->valuestring);
+        }
+    }
+    cJSON_Delete(object);
+}
+
+void InstallRecordStore::RemoveJsonFiles()
+{
+    BundleDaemonClient &client = BundleDaemonClient::GetInstance();
+    if (BundleUtil::IsDir(JSON_PATH) && client.RemoveFile(JSON_PATH) != EC_SUCCESS) {
+        HILOG_WARN(HILOG_MODULE_APP, "remove migrated record jsons fail!");
+    }
+    if (BundleUtil::IsFile(THIRD_SYSTEM_BUNDLE_JSON)) {
+        (void) client.RemoveFile(THIRD_SYSTEM_BUNDLE_JSON);
+    }
+    if (BundleUtil::IsFile(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON)) {
+        (void) client.RemoveFile(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON);
+    }
+}
+
+void InstallRecordStore::LoadIfNeeded()
+{
+    // called with mutex_ held
+    if (loaded_) {
+        return;
+    }
+    loaded_ = true;
+    std::string tmpPath = std::string(INSTALL_RECORD_STORE_PATH) + TMP_FILE_SUFFIX;
+    std::string bakPath = std::string(INSTALL_RECORD_STORE_PATH) + BAK_FILE_SUFFIX;
+    std::string corruptPath = std::string(INSTALL_RECORD_STORE_PATH) + CORRUPT_FILE_SUFFIX;
+    Tables tables;
+    if (ReadStoreFile(tmpPath.c_str(), tables)) {
+        // bundle_daemon removes the old store before renaming, a power loss in between leaves only the new one
+        HILOG_WARN(HILOG_MODULE_APP, "install record store was not renamed into place, finish it");
+        (void) BundleDaemonClient::GetInstance().RenameFile(tmpPath.c_str(), INSTALL_RECORD_STORE_PATH);
+        created_ = true;
+    } else if (ReadStoreFile(INSTALL_RECORD_STORE_PATH, tables)) {
+        created_ = true;
+    } else if (ReadStoreFile(bakPath.c_str(), tables)) {
+        // the changes of the last batch are lost, the records before it are not
+        HILOG_ERROR(HILOG_MODULE_APP, "install record store is corrupted or missing, fall back to the previous one");
+        if (BundleUtil::IsFile(INSTALL_RECORD_STORE_PATH)) {
+            (void) BundleDaemonClient::GetInstance().RenameFile(INSTALL_RECORD_STORE_PATH, corruptPath.c_str());
+        }
+        created_ = true;
+    } else if (BundleUtil::IsFile(INSTALL_RECORD_STORE_PATH)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "install record store is corrupted, move it aside!");
+        (void) BundleDaemonClient::GetInstance().RenameFile(INSTALL_RECORD_STORE_PATH, corruptPath.c_str());
+    } else if (BundleUtil::IsDir(JSON_PATH) || BundleUtil::IsFile(THIRD_SYSTEM_BUNDLE_JSON) ||
+        BundleUtil::IsFile(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON)) {
+        // the json files of an older version are read once and removed once the store holds them
+        MigrateRecordJsons(tables);
+        MigrateUidMap(tables);
+        MigrateBundleList(THIRD_SYSTEM_BUNDLE_JSON, tables.thirdSystemBundles);
+        MigrateBundleList(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON, tables.uninstalledThirdSystemBundles);
+        created_ = true;
+        if (!TextRecordFile::Write(INSTALL_RECORD_STORE_PATH, SerializeTables(tables))) {
+            HILOG_ERROR(HILOG_MODULE_APP, "store migrated install records fail, keep the json files!");
+            tables_ = std::move(tables);
+            return;
+        }
+        HILOG_INFO(HILOG_MODULE_APP, "migrate %{public}zu install records into the store", tables.records.size());
+    }
+    tables_ = std::move(tables);
+    if (created_) {
+        RemoveJsonFiles();
+    }
+}
+
+bool InstallRecordStore::IsCreated()
+{
+    pthread_mutex_lock(&mutex_);
+    LoadIfNeeded();
+    bool created = created_;
+    pthread_mutex_unlock(&mutex_);
+    return created;
+}
+
+bool InstallRecordStore::GetRecord(const std::string &bundleName, StoredRecord &record)
+{
+    pthread_mutex_lock(&mutex_);
+    LoadIfNeeded();
+    auto it = tables_.records.find(bundleName);
+    bool found = (it != tables_.records.end());
+    if (found) {
+        record = it->second;
+    }
+    pthread_mutex_unlock(&mutex_);
+    return found;
+}
+
+bool InstallRecordStore::CheckRecordIsValid(const std::string &bundleName, StoredRecord &record)
+{
+    return GetRecord(bundleName, record) && record.versionCode >= 0 && BundleUtil::IsDir(record.codePath.c_str()) &&
+        BundleUtil::EndWith(record.codePath.c_str(), bundleName.c_str());
+}
+
+void InstallRecordStore::GetUids(std::map<std::string, int32_t> &uids)
+{
+    pthread_mutex_lock(&mutex_);
+    LoadIfNeeded();
+    for (const auto &it : tables_.uids) {
+        uids[it.first] = it.second.uid;
+    }
+    pthread_mutex_unlock(&mutex_);
+}
+
+bool InstallRecordStore::IsThirdSystemBundle(const std::string &bundleName)
+{
+    pthread_mutex_lock(&mutex_);
+    LoadIfNeeded();
+    bool result = tables_.thirdSystemBundles.count(bundleName) != 0;
+    pthread_mutex_unlock(&mutex_);
+    return result;
+}
+
+bool InstallRecordStore::IsUninstalledThirdSystemBundle(const std::string &bundleName)
+{
+    pthread_mutex_lock(&mutex_);
+    LoadIfNeeded();
+    bool result = tables_.uninstalledThirdSystemBundles.count(bundleName) != 0;
+    pthread_mutex_unlock(&mutex_);
+    return result;
+}
+
+bool InstallRecordStore::Apply(const InstallRecordBatch &batch)
+{
+    if (batch.IsEmpty()) {
+        return true;
+    }
+    pthread_mutex_lock(&mutex_);
+    LoadIfNeeded();
+    // the batch goes to a copy, which replaces the tables once it is stored
+    Tables tables = tables_;
+    for (const auto &change : batch.changes_) {
+        switch (change.type) {
+            case InstallRecordBatch::PUT_RECORD: {
+                StoredRecord record = change.record;
+                record.serial = tables.nextSerial++;
+                tables.records[change.bundleName] = std::move(record);
+                UidEntry entry;
+                entry.uid = change.record.uid;
+                entry.gid = change.record.gid;
+                tables.uids[change.bundleName] = entry;
+                break;
+            }
+            case InstallRecordBatch::REMOVE_RECORD:
+                tables.records.erase(change.bundleName);
+                tables.uids.erase(change.bundleName);
+                break;
+            case InstallRecordBatch::RELEASE_UID:
+                tables.uids.erase(change.bundleName);
+                break;
+            case InstallRecordBatch::ADD_THIRD_SYSTEM_BUNDLE:
+                tables.thirdSystemBundles.insert(change.bundleName);
+                break;
+            case InstallRecordBatch::ADD_UNINSTALLED_THIRD_SYSTEM_BUNDLE:
+                tables.uninstalledThirdSystemBundles.insert(change.bundleName);
+                break;
+            default:
+                break;
+        }
+    }
+    // the current store becomes the previous generation, a power loss in between leaves only that one
+    std::string bakPath = std::string(INSTALL_RECORD_STORE_PATH) + BAK_FILE_SUFFIX;
+    if (BundleUtil::IsFile(INSTALL_RECORD_STORE_PATH) &&
+        BundleDaemonClient::GetInstance().RenameFile(INSTALL_RECORD_STORE_PATH, bakPath.c_str()) != EC_SUCCESS) {
+        HILOG_WARN(HILOG_MODULE_APP, "keep previous install record store fail!");
+    }
+    bool result = TextRecordFile::Write(INSTALL_RECORD_STORE_PATH, SerializeTables(tables));
+    if (result) {
+        tables_ = std::move(tables);
+        created_ = true;
+    } else {
+        HILOG_ERROR(HILOG_MODULE_APP, "store install records fail!");
+    }
+    pthread_mutex_unlock(&mutex_);
+    return result;
+}
+} // namespace OHOS
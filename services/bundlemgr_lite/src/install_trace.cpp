@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "install_trace.h"
+
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+#include <pthread.h>
+#include <time.h>
+#include "log.h"
+#else
+#include "bundlems_log.h"
+#include "cmsis_os2.h"
+#include "los_tick.h"
+#endif
+#include "securec.h"
+
+namespace OHOS {
+namespace {
+const char *PHASE_NAMES[INSTALL_PHASE_NUM] = {
+    "prepare", "parse", "verify", "extract", "transform", "permission", "record"
+};
+const uint64_t US_PER_SECOND = 1000000;
+const uint32_t NS_PER_US = 1000;
+}
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+static pthread_mutex_t g_installReportMutex = PTHREAD_MUTEX_INITIALIZER;
+#else
+const int32_t INSTALL_REPORT_MUTEX_TIMEOUT = 2000;
+static osMutexId_t g_installReportMutex;
+#endif
+
+static uint32_t ToCost(uint64_t cost)
+{
+    return (cost > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(cost);
+}
+
+uint64_t InstallTrace::GetCurrentTime()
+{
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    struct timespec now = { 0 };
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(now.tv_sec) * US_PER_SECOND + static_cast<uint64_t>(now.tv_nsec) / NS_PER_US;
+#else
+    return LOS_TickCountGet() * US_PER_SECOND / LOSCFG_BASE_CORE_TICK_PER_SECOND;
+#endif
+}
+
+const char *InstallTrace::GetPhaseName(InstallPhase phase)
+{
+    return (phase < INSTALL_PHASE_NUM) ? PHASE_NAMES[phase] : "";
+}
+
+void InstallTrace::Start()
+{
+    (void) memset_s(&report_, sizeof(report_), 0, sizeof(report_));
+    startTime_ = GetCurrentTime();
+    phaseStartTime_ = startTime_;
+    phase_ = INSTALL_PHASE_PREPARE;
+}
+
+void InstallTrace::BeginPhase(InstallPhase phase)
+{
+    EndPhase();
+    phaseStartTime_ = GetCurrentTime();
+    phase_ = phase;
+}
+
+void InstallTrace::EndPhase()
+{
+    if (phase_ >= INSTALL_PHASE_NUM) {
+        return;
+    }
+    AddPhaseCost(phase_, ToCost(GetCurrentTime() - phaseStartTime_));
+    phase_ = INSTALL_PHASE_NUM;
+}
+
+void InstallTrace::AddPhaseCost(InstallPhase phase, uint32_t cost)
+{
+    if (phase >= INSTALL_PHASE_NUM) {
+        return;
+    }
+    report_.phaseCost[phase] = ToCost(static_cast<uint64_t>(report_.phaseCost[phase]) + cost);
+}
+
+void InstallTrace::AddIo(uint32_t bytesRead, uint32_t bytesWritten, uint32_t fileCount)
+{
+    report_.bytesRead = ToCost(static_cast<uint64_t>(report_.bytesRead) + bytesRead);
+    report_.bytesWritten = ToCost(static_cast<uint64_t>(report_.bytesWritten) + bytesWritten);
+    report_.fileCount += fileCount;
+}
+
+void InstallTrace::SetBundleName(const char *bundleName)
+{
+    if (bundleName == nullptr) {
+        return;
+    }
+    (void) strncpy_s(report_.bundleName, sizeof(report_.bundleName), bundleName, MAX_BUNDLE_NAME_LEN);
+}
+
+void InstallTrace::Finish(uint8_t result)
+{
+    EndPhase();
+    report_.result = result;
+    report_.totalCost = ToCost(GetCurrentTime() - startTime_);
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    HILOG_INFO(HILOG_MODULE_APP, "install %{public}s result %{public}d cost %{public}u us",
+        report_.bundleName, result, report_.totalCost);
+#else
+    HILOG_INFO(HILOG_MODULE_AAFWK, "[BMS] install %s result %d cost %u us", report_.bundleName, result,
+        report_.totalCost);
+#endif
+    InstallReportRecorder::GetInstance().Add(report_);
+}
+
+InstallReportRecorder::InstallReportRecorder()
+{
+#ifndef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    g_installReportMutex = osMutexNew(reinterpret_cast<osMutexAttr_t *>(NULL));
+#endif
+}
+
+InstallReportRecorder::~InstallReportRecorder()
+{
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_mutex_destroy(&g_installReportMutex);
+#else
+    osMutexDelete(g_installReportMutex);
+#endif
+}
+
+void InstallReportRecorder::Add(const InstallReport &report)
+{
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_mutex_lock(&g_installReportMutex);
+#else
+    osMutexAcquire(g_installReportMutex, INSTALL_REPORT_MUTEX_TIMEOUT);
+#endif
+    reports_[next_] = report;
+    next_ = (next_ + 1) % MAX_INSTALL_REPORT_NUM;
+    if (count_ < MAX_INSTALL_REPORT_NUM) {
+        count_++;
+    }
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_mutex_unlock(&g_installReportMutex);
+#else
+    osMutexRelease(g_installReportMutex);
+#endif
+}
+
+uint32_t InstallReportRecorder::GetReports(InstallReport reports[], uint32_t num) const
+{
+    if (reports == nullptr) {
+        return 0;
+    }
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_mutex_lock(&g_installReportMutex);
+#else
+    osMutexAcquire(g_installReportMutex, INSTALL_REPORT_MUTEX_TIMEOUT);
+#endif
+    uint32_t copied = 0;
+    for (; copied < num && copied < count_; copied++) {
+        reports[copied] = reports_[(next_ + MAX_INSTALL_REPORT_NUM - 1 - copied) % MAX_INSTALL_REPORT_NUM];
+    }
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_mutex_unlock(&g_installReportMutex);
+#else
+    osMutexRelease(g_installReportMutex);
+#endif
+    return copied;
+}
+} // namespace OHOS
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "text_record_codec.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "adapter.h"
+#include "bundle_util.h"
+#include "log.h"
+#include "securec.h"
+#include "zlib.h"
+
+namespace OHOS {
+namespace {
+constexpr int32_t DECIMAL_BASE = 10;
+const char NULL_STRING_MARK = '-';
+const char LENGTH_END_MARK = ':';
+const char INT_END_MARK = ' ';
+const char HEADER_END_MARK = '\n';
+}
+
+void TextRecordWriter::PutInt(int64_t value)
+{
+    out_ += std::to_string(value);
+    out_ += INT_END_MARK;
+}
+
+void TextRecordWriter::PutString(const char *value)
+{
+    if (value == nullptr) {
+        out_ += NULL_STRING_MARK;
+        return;
+    }
+    out_ += std::to_string(strlen(value));
+    out_ += LENGTH_END_MARK;
+    out_ += value;
+}
+
+void TextRecordWriter::PutString(const std::string &value)
+{
+    PutString(value.c_str());
+}
+
+bool TextRecordReader::Skip(size_t length)
+{
+    if (length > end_ - pos_) {
+        return false;
+    }
+    pos_ += length;
+    return true;
+}
+
+static bool ParseDecimal(const std::string &content, size_t &pos, size_t end, char endMark, int64_t &value)
+{
+    bool isNegative = (pos < end && content[pos] == '-');
+    size_t index = isNegative ? pos + 1 : pos;
+    size_t start = index;
+    uint64_t absValue = 0;
+    for (; index < end && content[index] >= '0' && content[index] <= '9'; index++) {
+        if (absValue > (UINT64_MAX - (content[index] - '0')) / DECIMAL_BASE) {
+            return false;
+        }
+        absValue = absValue * DECIMAL_BASE + static_cast<uint64_t>(content[index] - '0');
+    }
+    if (index == start || index >= end || content[index] != endMark || absValue > INT64_MAX) {
+        return false;
+    }
+    value = isNegative ? -static_cast<int64_t>(absValue) : static_cast<int64_t>(absValue);
+    pos = index + 1;
+    return true;
+}
+
+bool TextRecordReader::GetInt(int64_t &value)
+{
+    return ParseDecimal(content_, pos_, end_, INT_END_MARK, value);
+}
+
+bool TextRecordReader::GetBool(bool &value)
+{
+    int64_t number = 0;
+    if (!GetInt(number) || (number != 0 && number != 1)) {
+        return false;
+    }
+    value = (number == 1);
+    return true;
+}
+
+bool TextRecordReader::GetRawString(const char *&value, size_t &length)
+{
+    if (pos_ < end_ && content_[pos_] == NULL_STRING_MARK) {
+        pos_++;
+        value = nullptr;
+        length = 0;
+        return true;
+    }
+    int64_t stringLength = 0;
+    if (!ParseDecimal(content_, pos_, end_, LENGTH_END_MARK, stringLength) || stringLength < 0 ||
+        static_cast<uint64_t>(stringLength) > end_ - pos_) {
+        return false;
+    }
+    value = content_.data() + pos_;
+    length = static_cast<size_t>(stringLength);
+    pos_ += length;
+    return true;
+}
+
+bool TextRecordReader::GetString(std::string &value)
+{
+    const char *data = nullptr;
+    size_t length = 0;
+    if (!GetRawString(data, length) || data == nullptr) {
+        return false;
+    }
+    value.assign(data, length);
+    return true;
+}
+
+bool TextRecordReader::GetString(char *&value)
+{
+    const char *data = nullptr;
+    size_t length = 0;
+    if (!GetRawString(data, length)) {
+        return false;
+    }
+    if (data == nullptr) {
+        value = nullptr;
+        return true;
+    }
+    value = reinterpret_cast<char *>(AdapterMalloc(length + 1));
+    if (value == nullptr || (length > 0 && memcpy_s(value, length + 1, data, length) != EOK)) {
+        AdapterFree(value);
+        value = nullptr;
+        return false;
+    }
+    value[length] = '\0';
+    return true;
+}
+
+static uint32_t GetChecksum(const char *data, size_t length)
+{
+    unsigned long crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(data),
+        static_cast<uInt>(length));
+    return static_cast<uint32_t>(crc);
+}
+
+std::string TextRecordFile::Seal(const char *magic, int64_t version, const std::string &payload)
+{
+    std::string content;
+    TextRecordWriter writer(content);
+    writer.PutString(magic);
+    writer.PutInt(version);
+    writer.PutInt(GetChecksum(payload.data(), payload.size()));
+    writer.PutInt(static_cast<int64_t>(payload.size()));
+    content += HEADER_END_MARK;
+    content += payload;
+    return content;
+}
+
+bool TextRecordFile::Unseal(const std::string &content, const char *magic, int64_t version, size_t &payloadOffset)
+{
+    size_t headerEnd = content.find(HEADER_END_MARK);
+    if (headerEnd == std::string::npos) {
+        return false;
+    }
+    TextRecordReader reader(content, 0, headerEnd);
+    std::string fileMagic;
+    int64_t fileVersion = 0;
+    uint32_t checksum = 0;
+    int64_t payloadLength = 0;
+    if (!reader.GetString(fileMagic) || fileMagic != magic || !reader.GetInt(fileVersion) ||
+        fileVersion != version || !reader.GetInt(checksum) || !reader.GetInt(payloadLength) ||
+        reader.GetPos() != headerEnd) {
+        return false;
+    }
+    payloadOffset = headerEnd + 1;
+    if (static_cast<uint64_t>(payloadLength) != content.size() - payloadOffset) {
+        return false;
+    }
+    return GetChecksum(content.data() + payloadOffset, content.size() - payloadOffset) == checksum;
+}
+
+bool TextRecordFile::Read(const char *path, off_t maxSize, std::string &content)
+{
+    const char *dirEnd = (path == nullptr) ? nullptr : strrchr(path, '/');
+    if (dirEnd == nullptr || dirEnd == path) {
+        return false;
+    }
+    std::string dir(path, dirEnd - path);
+    int32_t fd = open(path, O_RDONLY | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    }
+    // only bundle_daemon writes these files, anything else may have changed them
+    struct stat dirStat;
+    struct stat fileStat;
+    if (stat(dir.c_str(), &dirStat) != 0 || fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) ||
+        fileStat.st_uid != dirStat.st_uid || (fileStat.st_mode & (S_IWGRP | S_IWOTH)) != 0 ||
+        (dirStat.st_mode & (S_IWGRP | S_IWOTH)) != 0 || fileStat.st_size <= 0 || fileStat.st_size > maxSize) {
+        HILOG_WARN(HILOG_MODULE_APP, "%{public}s is not owned by bundle_daemon!", path);
+        close(fd);
+        return false;
+    }
+    content.resize(static_cast<size_t>(fileStat.st_size));
+    size_t readLength = 0;
+    while (readLength < content.size()) {
+        ssize_t readBytes = read(fd, &content[readLength], content.size() - readLength);
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            close(fd);
+            content.clear();
+            return false;
+        }
+        readLength += static_cast<size_t>(readBytes);
+    }
+    close(fd);
+    return true;
+}
+
+bool TextRecordFile::Write(const char *path, const std::string &content)
+{
+    return BundleUtil::StoreContentInChunks(path, content);
+}
+} // namespace OHOS
@@ -16,9 +16,16 @@
 #include "zip_file.h"
 
 #include <cassert>
+#include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 #include <limits>
+#include <new>
 #include <ostream>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "log.h"
 #include "securec.h"
@@ -43,10 +50,31 @@ constexpr uint32_t CENTRAL_SIGNATURE = 0x02014b50;
 constexpr uint32_t EOCD_SIGNATURE = 0x06054b50;
 constexpr uint32_t DATA_DESC_SIGNATURE = 0x08074b50;
 constexpr uint32_t FLAG_DATA_DESC = 0x8;
-constexpr size_t FILE_READ_COUNT = 1;
 constexpr uint8_t INFLATE_ERROR_TIMES = 5;
+// deflated entries up to this size are inflated with a single call, see SetWholeInflateLimit.
+constexpr uint32_t DEFAULT_WHOLE_INFLATE_LIMIT = 64 * UNZIP_BUFFER_SIZE;
+// an entry read into memory is a profile or a resource index, a larger size in its header is a broken hap
+constexpr uint32_t MAX_BUFFER_ENTRY_SIZE = 1024 * UNZIP_BUFFER_SIZE;
+constexpr size_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr size_t FNV_PRIME = 16777619U;
 } // namespace
 
+bool ZipEntryName::operator==(const ZipEntryName &other) const
+{
+    return (length == other.length) && ((length == 0) || (memcmp(data, other.data, length) == 0));
+}
+
+size_t ZipEntryNameHash::operator()(const ZipEntryName &name) const
+{
+    // FNV-1a, names are hashed in place without building a std::string.
+    size_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < name.length; i++) {
+        hash ^= static_cast<unsigned char>(name.data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
 ZipEntry::ZipEntry(const CentralDirEntry &centralEntry)
 {
     compressionMethod = centralEntry.compressionMethod;
@@ -58,7 +86,7 @@ ZipEntry::ZipEntry(const CentralDirEntry &centralEntry)
 }
 
 ZipFile::ZipFile(const std::string &pathName)
-    : pathName_(pathName)
+    : pathName_(pathName), wholeInflateLimit_(DEFAULT_WHOLE_INFLATE_LIMIT)
 {
     HILOG_INFO(HILOG_MODULE_APP, "create ZipFile instance");
 }
@@ -95,11 +123,7 @@ bool ZipFile::ParseEndDirectory()
         return false;
     }
     ZipPos eocdPos = endFilePos - endDirLen;
-    if (fseek(file_, eocdPos, SEEK_SET) != 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "locate EOCD seek failed, error: %{public}s", strerror(errno));
-        return false;
-    }
-    if (fread(&endDir_, sizeof(EndDir), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
+    if (!ReadAt(&endDir_, sizeof(EndDir), eocdPos)) {
         HILOG_ERROR(HILOG_MODULE_APP, "read EOCD struct failed, error: %{public}s", strerror(errno));
         return false;
     }
@@ -107,70 +131,106 @@ bool ZipFile::ParseEndDirectory()
     return CheckEndDir(endDir_);
 }
 
-bool ZipFile::ParseAllEntries()
+bool ZipFile::ReadCentralDir()
 {
-    bool ret = true;
-    ZipPos currentPos = centralDirPos_;
-    CentralDirEntry directoryEntry = {};
-    size_t fileLength = 0;
+    // read the whole central directory in one io and parse the entries in place.
+    size_t centralDirSize = endDir_.sizeOfCentralDir;
+    centralDir_.reset(new (std::nothrow) char[centralDirSize + 1]);
+    if (centralDir_ == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "new central dir buffer failed, size: %{public}zu", centralDirSize);
+        return false;
+    }
+    if (!ReadAt(centralDir_.get(), centralDirSize, centralDirPos_)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "read central dir failed, error: %{public}s", strerror(errno));
+        return false;
+    }
+    return true;
+}
 
-    for (int32_t i = 0; i < endDir_.totalEntries; i++) {
-        std::string fileName;
-        fileName.reserve(MAX_FILE_NAME);
-        fileName.resize(MAX_FILE_NAME - 1);
+bool ZipFile::ParseCentralEntry(int32_t index, size_t &currentPos, ZipEntry &zipEntry) const
+{
+    size_t centralDirSize = endDir_.sizeOfCentralDir;
+    CentralDirEntry directoryEntry = {};
+    if (centralDirSize - currentPos < sizeof(CentralDirEntry)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "parse entry(%{public}d) out of central dir", index);
+        return false;
+    }
+    if (memcpy_s(&directoryEntry, sizeof(CentralDirEntry), centralDir_.get() + currentPos,
+        sizeof(CentralDirEntry)) != EOK) {
+        return false;
+    }
 
-        if (fseek(file_, currentPos, SEEK_SET) != 0) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "parse entry(%{public}d) seek zipEntry failed, error: %{public}s", i, strerror(errno));
-            ret = false;
-            break;
-        }
+    if (directoryEntry.signature != CENTRAL_SIGNATURE) {
+        HILOG_ERROR(HILOG_MODULE_APP,
+            "parse entry(%{public}d) check signature(0x%{public}08x) at pos(0x%{public}08llx) failed",
+            index, directoryEntry.signature, centralDirPos_ + currentPos);
+        return false;
+    }
 
-        if (fread(&directoryEntry, sizeof(CentralDirEntry), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-            HILOG_ERROR(HILOG_MODULE_APP, "parse entry(%{public}d) read ZipEntry failed, error: %{public}s",
-                i, strerror(errno));
-            ret = false;
-            break;
-        }
+    size_t entrySize = sizeof(CentralDirEntry) + directoryEntry.nameSize + directoryEntry.extraSize +
+        directoryEntry.commentSize;
+    if (centralDirSize - currentPos < entrySize) {
+        HILOG_ERROR(HILOG_MODULE_APP, "parse entry(%{public}d) name or extra out of central dir", index);
+        return false;
+    }
 
-        if (directoryEntry.signature != CENTRAL_SIGNATURE) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "parse entry(%{public}d) check signature(0x%{public}08x) at pos(0x%{public}08llx) failed",
-                i, directoryEntry.signature, currentPos);
-            ret = false;
-            break;
-        }
+    zipEntry = ZipEntry(directoryEntry);
+    zipEntry.fileName.data = centralDir_.get() + currentPos + sizeof(CentralDirEntry);
+    zipEntry.fileName.length =
+        (directoryEntry.nameSize >= MAX_FILE_NAME) ? (MAX_FILE_NAME - 1) : (directoryEntry.nameSize);
+    currentPos += entrySize;
+    return true;
+}
 
-        fileLength = (directoryEntry.nameSize >= MAX_FILE_NAME) ? (MAX_FILE_NAME - 1) : (directoryEntry.nameSize);
-        if (fread(&(fileName[0]), fileLength, FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "parse entry(%{public}d) read file name failed, error: %{public}s", i, strerror(errno));
-            ret = false;
-            break;
+bool ZipFile::ParseAllEntries()
+{
+    entriesMap_.reserve(endDir_.totalEntries);
+    fileNames_.reserve(endDir_.totalEntries);
+    size_t currentPos = 0;
+    ZipEntry currentEntry;
+    for (int32_t i = 0; i < endDir_.totalEntries; i++) {
+        if (!ParseCentralEntry(i, currentPos, currentEntry)) {
+            return false;
         }
-        fileName.resize(fileLength);
-
-        ZipEntry currentEntry(directoryEntry);
-        currentEntry.fileName = fileName;
-        entriesMap_[fileName] = currentEntry;
-        fileNames_.emplace_back(fileName);
-
-        ZIPPOS_ADD_AND_CHECK_OVERFLOW(currentPos, sizeof(directoryEntry), currentPos);
-        ZIPPOS_ADD_AND_CHECK_OVERFLOW(currentPos, directoryEntry.nameSize, currentPos);
-        ZIPPOS_ADD_AND_CHECK_OVERFLOW(currentPos, directoryEntry.extraSize, currentPos);
-        ZIPPOS_ADD_AND_CHECK_OVERFLOW(currentPos, directoryEntry.commentSize, currentPos);
+        entriesMap_[currentEntry.fileName] = currentEntry;
+        fileNames_.emplace_back(currentEntry.fileName);
     }
+    isIndexed_ = true;
     HILOG_INFO(HILOG_MODULE_APP, "parse %{public}d central entries from %{private}s", endDir_.totalEntries,
         pathName_.c_str());
-    return ret;
+    return true;
+}
+
+bool ZipFile::ScanEntry(const ZipEntryName &entryName, ZipEntry &zipEntry) const
+{
+    size_t currentPos = 0;
+    for (int32_t i = 0; i < endDir_.totalEntries; i++) {
+        if (!ParseCentralEntry(i, currentPos, zipEntry)) {
+            return false;
+        }
+        if (zipEntry.fileName == entryName) {
+            return true;
+        }
+    }
+    return false;
 }
 
-const std::vector<std::string> &ZipFile::GetFileNames() const
+const std::vector<ZipEntryName> &ZipFile::GetFileNames() const
 {
     return fileNames_;
 }
 
 bool ZipFile::Open()
+{
+    return OpenFile(true);
+}
+
+bool ZipFile::OpenWithoutIndex()
+{
+    return OpenFile(false);
+}
+
+bool ZipFile::OpenFile(bool buildIndex)
 {
     HILOG_INFO(HILOG_MODULE_APP, "open: %{private}s", pathName_.c_str());
     if (isOpen_) {
@@ -189,29 +249,33 @@ bool ZipFile::Open()
         return false;
     }
 
-    FILE* tmpFile = fopen(realPath, "rb");
-    if (tmpFile == nullptr) {
+    int32_t tmpFd = open(realPath, O_RDONLY);
+    if (tmpFd < 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "open file(%{public}s) failed, error: %{private}s", pathName_.c_str(),
             strerror(errno));
         return false;
     }
 
-    if (fseek(tmpFile, 0, SEEK_END) != 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "file seek failed, error: %{public}s", strerror(errno));
-        fclose(tmpFile);
+    struct stat fileStat = {};
+    if (fstat(tmpFd, &fileStat) != 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "file stat failed, error: %{public}s", strerror(errno));
+        close(tmpFd);
         return false;
     }
 
-    ZipPos fileLength = ftell(tmpFile);
     if (fileLength_ == 0) {
-        fileLength_ = fileLength;
+        fileLength_ = static_cast<ZipPos>(fileStat.st_size);
     }
 
-    file_ = tmpFile;
-    bool result = ParseEndDirectory();
-    if (result) {
+    fd_ = tmpFd;
+    bool result = ParseEndDirectory() && ReadCentralDir();
+    if (result && buildIndex) {
         result = ParseAllEntries();
     }
+    if (result) {
+        // entry data sits in front of the central directory, which has been read completely already
+        AdviseFileRead(fd_, 0, static_cast<off_t>(centralDirPos_), readHint_);
+    }
     // it means open file success.
     isOpen_ = true;
     return result;
@@ -220,20 +284,44 @@ bool ZipFile::Open()
 void ZipFile::Close()
 {
     HILOG_INFO(HILOG_MODULE_APP, "close: %{private}s", pathName_.c_str());
-    if (!isOpen_ || file_ == nullptr) {
+    if (!isOpen_ || fd_ < 0) {
         HILOG_WARN(HILOG_MODULE_APP, "file is not opened");
         return;
     }
 
     entriesMap_.clear();
     fileNames_.clear();
+    centralDir_.reset();
+    isIndexed_ = false;
     pathName_ = "";
     isOpen_ = false;
 
-    if (fclose(file_) != 0) {
+    if (dropCacheOnClose_) {
+        AdviseFileDrop(fd_, 0, 0);
+    }
+    if (close(fd_) != 0) {
         HILOG_WARN(HILOG_MODULE_APP, "close failed, error: %{public}s", strerror(errno));
     }
-    file_ = nullptr;
+    fd_ = -1;
+}
+
+bool ZipFile::ReadAt(void *buffer, size_t length, ZipPos offset) const
+{
+    // pread does not touch the shared file offset, so concurrent readers never interfere with each other.
+    char *dest = static_cast<char *>(buffer);
+    size_t readLength = 0;
+    while (readLength < length) {
+        ssize_t readBytes = pread(fd_, dest + readLength, length - readLength,
+            static_cast<off_t>(offset + readLength));
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            return false;
+        }
+        readLength += static_cast<size_t>(readBytes);
+    }
+    return true;
 }
 
 // Get all file zipEntry in this file
@@ -245,7 +333,18 @@ const ZipEntryMap &ZipFile::GetAllEntries() const
 bool ZipFile::GetEntry(const std::string &entryName, ZipEntry &resultEntry) const
 {
     HILOG_INFO(HILOG_MODULE_APP, "get entry by name: %{public}s", entryName.c_str());
-    auto iter = entriesMap_.find(entryName);
+    ZipEntryName name;
+    name.data = entryName.c_str();
+    name.length = entryName.length();
+    if (!isIndexed_) {
+        if (centralDir_ != nullptr && ScanEntry(name, resultEntry)) {
+            HILOG_DEBUG(HILOG_MODULE_APP, "get entry successed");
+            return true;
+        }
+        HILOG_ERROR(HILOG_MODULE_APP, "get entry failed");
+        return false;
+    }
+    auto iter = entriesMap_.find(name);
     if (iter != entriesMap_.end()) {
         resultEntry = iter->second;
         HILOG_DEBUG(HILOG_MODULE_APP, "get entry successed");
@@ -281,13 +380,7 @@ bool ZipFile::CheckDataDesc(const ZipEntry &zipEntry, const LocalHeader &localHe
         ZIPPOS_ADD_AND_CHECK_OVERFLOW(zipEntry.localHeaderOffset, localHeaderSize, descPos);
         ZIPPOS_ADD_AND_CHECK_OVERFLOW(descPos, zipEntry.compressedSize, descPos);
 
-        if (fseek(file_, descPos, SEEK_SET) != 0) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "check local header seek datadesc failed, error: %{public}s", strerror(errno));
-            return false;
-        }
-
-        if (fread(&dataDesc, sizeof(DataDesc), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
+        if (!ReadAt(&dataDesc, sizeof(DataDesc), descPos)) {
             HILOG_ERROR(HILOG_MODULE_APP, "check local header read datadesc failed, error: %{public}s",
                 strerror(errno));
             return false;
@@ -326,11 +419,7 @@ bool ZipFile::CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extr
             zipEntry.localHeaderOffset);
         return false;
     }
-    if (fseek(file_, zipEntry.localHeaderOffset, SEEK_SET) != 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "check local header seek failed, error: %{public}s", strerror(errno));
-        return false;
-    }
-    if (fread(&localHeader, sizeof(LocalHeader), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
+    if (!ReadAt(&localHeader, sizeof(LocalHeader), zipEntry.localHeaderOffset)) {
         HILOG_ERROR(HILOG_MODULE_APP, "check local header read localheader failed, error: %{public}s",
             strerror(errno));
         return false;
@@ -348,20 +437,20 @@ bool ZipFile::CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extr
         return false;
     }
 
-    std::string fileName;
-    fileName.reserve(MAX_FILE_NAME);
-    fileName.resize(MAX_FILE_NAME - 1);
+    char fileName[MAX_FILE_NAME] = { 0 };
     size_t fileLength = (localHeader.nameSize >= MAX_FILE_NAME) ? (MAX_FILE_NAME - 1) : localHeader.nameSize;
-    if (fileLength != zipEntry.fileName.length()) {
+    if (fileLength != zipEntry.fileName.length) {
         HILOG_ERROR(HILOG_MODULE_APP, "check local header file name size failed");
         return false;
     }
-    if (fread(&(fileName[0]), fileLength, FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
+    if (!ReadAt(fileName, fileLength, zipEntry.localHeaderOffset + sizeof(LocalHeader))) {
         HILOG_ERROR(HILOG_MODULE_APP, "check local header read file name failed, error: %{public}s", strerror(errno));
         return false;
     }
-    fileName.resize(fileLength);
-    if (zipEntry.fileName != fileName) {
+    ZipEntryName localName;
+    localName.data = fileName;
+    localName.length = fileLength;
+    if (!(zipEntry.fileName == localName)) {
         HILOG_ERROR(HILOG_MODULE_APP, "check local header file name corrupted");
         return false;
     }
@@ -374,11 +463,11 @@ bool ZipFile::CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extr
     return true;
 }
 
-bool ZipFile::SeekToEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize) const
+bool ZipFile::GetEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize, ZipPos &startOffset) const
 {
-    ZipPos startOffset = zipEntry.localHeaderOffset;
+    startOffset = zipEntry.localHeaderOffset;
     // get data offset, add signature+localheader+namesize+extrasize
-    size_t localHeaderSize = GetLocalHeaderSize(zipEntry.fileName.length(), extraSize);
+    size_t localHeaderSize = GetLocalHeaderSize(zipEntry.fileName.length, extraSize);
     if (localHeaderSize == 0) {
         return false;
     }
@@ -390,40 +479,51 @@ bool ZipFile::SeekToEntryStart(const ZipEntry &zipEntry, const uint16_t extraSiz
             "(%{public}ud) > fileLength(%{public}llu)", startOffset, zipEntry.compressedSize, fileLength_);
         return false;
     }
-    HILOG_INFO(HILOG_MODULE_APP, "seek to entry start 0x%{public}08llx", startOffset);
-    if (fseek(file_, startOffset, SEEK_SET) != 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "seek failed, error: %{public}s", strerror(errno));
-        return false;
-    }
+    HILOG_INFO(HILOG_MODULE_APP, "entry start 0x%{public}08llx", startOffset);
     return true;
 }
 
 bool ZipFile::UnzipWithStore(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const
 {
     HILOG_INFO(HILOG_MODULE_APP, "unzip with store");
-    if (!SeekToEntryStart(zipEntry, extraSize)) {
+    ZipPos readPos = 0;
+    if (!GetEntryStart(zipEntry, extraSize, readPos)) {
         return false;
     }
 
     uint32_t remainSize = zipEntry.compressedSize;
+    uLong crc = crc32(0L, Z_NULL, 0);
     std::string readBuffer;
     readBuffer.reserve(UNZIP_BUF_OUT_LEN);
     readBuffer.resize(UNZIP_BUF_OUT_LEN - 1);
     while (remainSize > 0) {
-        size_t readBytes;
         size_t readLen = (remainSize > UNZIP_BUF_OUT_LEN) ? UNZIP_BUF_OUT_LEN : remainSize;
-        readBytes = fread(&(readBuffer[0]), sizeof(Byte), readLen, file_);
-        if (readBytes == 0) {
+        if (!ReadAt(&(readBuffer[0]), readLen, readPos)) {
             HILOG_ERROR(HILOG_MODULE_APP, "unzip store read failed, error: %{public}s", strerror(errno));
             return false;
         }
-        remainSize -= readBytes;
-        dest.write(&(readBuffer[0]), readBytes);
+        readPos += readLen;
+        remainSize -= readLen;
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(&(readBuffer[0])), readLen);
+        dest.write(&(readBuffer[0]), readLen);
+    }
+    if (!CheckEntryCrc(zipEntry, crc)) {
+        return false;
     }
     HILOG_INFO(HILOG_MODULE_APP, "unzip with store success");
     return true;
 }
 
+bool ZipFile::CheckEntryCrc(const ZipEntry &zipEntry, uLong crc) const
+{
+    if (static_cast<uint32_t>(crc) != zipEntry.crc) {
+        HILOG_ERROR(HILOG_MODULE_APP, "entry %{public}s crc(0x%{public}08x) mismatch, expect 0x%{public}08x",
+            zipEntry.fileName.ToString().c_str(), static_cast<uint32_t>(crc), zipEntry.crc);
+        return false;
+    }
+    return true;
+}
+
 bool ZipFile::InitZStream(z_stream &zstream) const
 {
     // init zlib stream
@@ -455,17 +555,17 @@ bool ZipFile::InitZStream(z_stream &zstream) const
     return true;
 }
 
-bool ZipFile::ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &remainCompressedSize) const
+bool ZipFile::ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &remainCompressedSize,
+    ZipPos &readPos) const
 {
     if (zstream.avail_in == 0) {
-        size_t readBytes;
-        size_t remainBytes = (remainCompressedSize > UNZIP_BUF_IN_LEN) ? UNZIP_BUF_IN_LEN : remainCompressedSize;
-        readBytes = fread(buffer, sizeof(Byte), remainBytes, file_);
-        if (readBytes == 0) {
+        size_t readBytes = (remainCompressedSize > UNZIP_BUF_IN_LEN) ? UNZIP_BUF_IN_LEN : remainCompressedSize;
+        if (readBytes == 0 || !ReadAt(buffer, readBytes, readPos)) {
             HILOG_ERROR(HILOG_MODULE_APP, "unzip inflated read failed, error: %{public}s", strerror(errno));
             return false;
         }
 
+        readPos += readBytes;
         remainCompressedSize -= readBytes;
         zstream.avail_in = readBytes;
         zstream.next_in = buffer;
@@ -473,13 +573,81 @@ bool ZipFile::ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &re
     return true;
 }
 
+void ZipFile::SetWholeInflateLimit(uint32_t limit)
+{
+    wholeInflateLimit_ = limit;
+}
+
+void ZipFile::SetReadHint(FileReadHint hint, bool dropCacheOnClose)
+{
+    readHint_ = hint;
+    dropCacheOnClose_ = dropCacheOnClose;
+}
+
+bool ZipFile::InflateToBuffer(const ZipEntry &zipEntry, ZipPos readPos, Byte *dest) const
+{
+    std::unique_ptr<Byte[]> bufIn(new (std::nothrow) Byte[zipEntry.compressedSize + 1]);
+    if (bufIn == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip whole inflated new buffer failed");
+        return false;
+    }
+    if (!ReadAt(bufIn.get(), zipEntry.compressedSize, readPos)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip whole inflated read failed, error: %{public}s", strerror(errno));
+        return false;
+    }
+
+    z_stream zstream;
+    if (memset_s(&zstream, sizeof(z_stream), 0, sizeof(z_stream))) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip stream buffer init failed");
+        return false;
+    }
+    int32_t zlibErr = inflateInit2(&zstream, -MAX_WBITS);
+    if (zlibErr != Z_OK) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip inflated init failed");
+        return false;
+    }
+    zstream.next_in = bufIn.get();
+    zstream.avail_in = zipEntry.compressedSize;
+    zstream.next_out = dest;
+    // one more output byte than expected, so that an entry longer than its recorded size is detected
+    zstream.avail_out = zipEntry.uncompressedSize + 1;
+    zlibErr = inflate(&zstream, Z_FINISH);
+    uLong inflateLen = zstream.total_out;
+    (void) inflateEnd(&zstream);
+    if (zlibErr != Z_STREAM_END || inflateLen != zipEntry.uncompressedSize) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip whole inflated inflate, error: %{public}d", zlibErr);
+        return false;
+    }
+    return CheckEntryCrc(zipEntry, crc32(crc32(0L, Z_NULL, 0), dest, inflateLen));
+}
+
+bool ZipFile::UnzipWholeInflated(const ZipEntry &zipEntry, ZipPos readPos, std::ostream &dest) const
+{
+    HILOG_INFO(HILOG_MODULE_APP, "unzip with whole inflated");
+    std::unique_ptr<Byte[]> bufOut(new (std::nothrow) Byte[zipEntry.uncompressedSize + 1]);
+    if (bufOut == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip whole inflated new buffer failed");
+        return false;
+    }
+    if (!InflateToBuffer(zipEntry, readPos, bufOut.get())) {
+        return false;
+    }
+    dest.write(reinterpret_cast<const char *>(bufOut.get()), zipEntry.uncompressedSize);
+    HILOG_INFO(HILOG_MODULE_APP, "unzip with whole inflated success");
+    return true;
+}
+
 bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const
 {
     HILOG_INFO(HILOG_MODULE_APP, "unzip with inflated");
     z_stream zstream;
-    if (!SeekToEntryStart(zipEntry, extraSize)) {
+    ZipPos readPos = 0;
+    if (!GetEntryStart(zipEntry, extraSize, readPos)) {
         return false;
     }
+    if (zipEntry.uncompressedSize <= wholeInflateLimit_ && zipEntry.compressedSize <= wholeInflateLimit_) {
+        return UnzipWholeInflated(zipEntry, readPos, dest);
+    }
     if (!InitZStream(zstream)) {
         return false;
     }
@@ -491,9 +659,10 @@ bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSi
     uint32_t remainCompressedSize = zipEntry.compressedSize;
     size_t inflateLen = 0;
     uint8_t errorTimes = 0;
+    uLong crc = crc32(0L, Z_NULL, 0);
 
     while ((remainCompressedSize > 0) || (zstream.avail_in > 0)) {
-        if (!ReadZStream(bufIn, zstream, remainCompressedSize)) {
+        if (!ReadZStream(bufIn, zstream, remainCompressedSize, readPos)) {
             ret = false;
             break;
         }
@@ -510,6 +679,7 @@ bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSi
 
         inflateLen = UNZIP_BUF_OUT_LEN - zstream.avail_out;
         if (inflateLen > 0) {
+            crc = crc32(crc, bufOut, inflateLen);
             dest.write((const char*)bufOut, inflateLen);
             zstream.next_out = bufOut;
             zstream.avail_out = UNZIP_BUF_OUT_LEN;
@@ -531,6 +701,9 @@ bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSi
         HILOG_ERROR(HILOG_MODULE_APP, "unzip inflateEnd error, error: %{public}d", zlibErr);
         ret = false;
     }
+    if (ret && !CheckEntryCrc(zipEntry, crc)) {
+        ret = false;
+    }
     HILOG_INFO(HILOG_MODULE_APP, "unzip with inflated success");
 
     delete[] bufOut;
@@ -560,4 +733,118 @@ bool ZipFile::ExtractFile(const std::string &file, std::ostream &dest) const
     }
     return ret;
 }
+
+bool ZipFile::ExtractFileToBuffer(const std::string &file, std::unique_ptr<char[]> &buffer, size_t &length) const
+{
+    HILOG_INFO(HILOG_MODULE_APP, "extract file %{public}s to buffer", file.c_str());
+    ZipEntry zipEntry;
+    if (!GetEntry(file, zipEntry)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "extract file: not find file");
+        return false;
+    }
+
+    uint16_t extraSize = 0;
+    ZipPos readPos = 0;
+    if (!CheckCoherencyLocalHeader(zipEntry, extraSize) || !GetEntryStart(zipEntry, extraSize, readPos)) {
+        return false;
+    }
+
+    if (zipEntry.uncompressedSize > MAX_BUFFER_ENTRY_SIZE) {
+        HILOG_ERROR(HILOG_MODULE_APP, "entry is too large for a buffer, size: %{public}u", zipEntry.uncompressedSize);
+        return false;
+    }
+    std::unique_ptr<char[]> result(new (std::nothrow) char[static_cast<size_t>(zipEntry.uncompressedSize) + 1]);
+    if (result == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "new entry buffer failed, size: %{public}u", zipEntry.uncompressedSize);
+        return false;
+    }
+    Byte *dest = reinterpret_cast<Byte *>(result.get());
+    if (zipEntry.compressionMethod == 0) {
+        if (zipEntry.compressedSize != zipEntry.uncompressedSize ||
+            !ReadAt(dest, zipEntry.uncompressedSize, readPos) ||
+            !CheckEntryCrc(zipEntry, crc32(crc32(0L, Z_NULL, 0), dest, zipEntry.uncompressedSize))) {
+            return false;
+        }
+    } else if (!InflateToBuffer(zipEntry, readPos, dest)) {
+        return false;
+    }
+    result[zipEntry.uncompressedSize] = '\0';
+    buffer = std::move(result);
+    length = zipEntry.uncompressedSize;
+    return true;
+}
+
+bool ZipFile::KernelCopy(int32_t destFd, ZipPos srcOffset, uint32_t length) const
+{
+    off_t inOffset = static_cast<off_t>(srcOffset);
+    uint32_t remainSize = length;
+    bool useSendfile = false;
+    while (remainSize > 0) {
+        ssize_t copyBytes = -1;
+#ifdef __NR_copy_file_range
+        if (!useSendfile) {
+            loff_t copyOffset = static_cast<loff_t>(inOffset);
+            copyBytes = syscall(__NR_copy_file_range, fd_, &copyOffset, destFd, nullptr, remainSize, 0);
+            if (copyBytes < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+                useSendfile = true;
+                continue;
+            }
+            inOffset = static_cast<off_t>(copyOffset);
+        }
+#else
+        useSendfile = true;
+#endif
+        if (useSendfile) {
+            // sendfile with an explicit offset leaves the shared file offset of fd_ untouched.
+            copyBytes = sendfile(destFd, fd_, &inOffset, remainSize);
+        }
+        if (copyBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (copyBytes <= 0) {
+            HILOG_WARN(HILOG_MODULE_APP, "kernel copy failed, error: %{public}s", strerror(errno));
+            return false;
+        }
+        remainSize -= static_cast<uint32_t>(copyBytes);
+    }
+    return true;
+}
+
+bool ZipFile::CheckFdCrc(const ZipEntry &zipEntry, int32_t destFd) const
+{
+    // the copied bytes are still in the page cache, so this does not read the flash again.
+    Byte buffer[UNZIP_BUF_OUT_LEN];
+    uLong crc = crc32(0L, Z_NULL, 0);
+    off_t offset = 0;
+    while (offset < static_cast<off_t>(zipEntry.uncompressedSize)) {
+        ssize_t readBytes = pread(destFd, buffer, UNZIP_BUF_OUT_LEN, offset);
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0) {
+            return false;
+        }
+        crc = crc32(crc, buffer, static_cast<uInt>(readBytes));
+        offset += readBytes;
+    }
+    return (offset == static_cast<off_t>(zipEntry.uncompressedSize)) && CheckEntryCrc(zipEntry, crc);
+}
+
+bool ZipFile::CopyStoredFile(const std::string &file, int32_t destFd) const
+{
+    ZipEntry zipEntry;
+    if (destFd < 0 || !GetEntry(file, zipEntry) || zipEntry.compressionMethod != 0) {
+        return false;
+    }
+
+    uint16_t extraSize = 0;
+    ZipPos startOffset = 0;
+    if (!CheckCoherencyLocalHeader(zipEntry, extraSize) || !GetEntryStart(zipEntry, extraSize, startOffset)) {
+        return false;
+    }
+    if (!KernelCopy(destFd, startOffset, zipEntry.compressedSize)) {
+        return false;
+    }
+    return CheckFdCrc(zipEntry, destFd);
+}
 }
@@ -36,6 +36,7 @@ private:
     void GetInstallBundleInfo(const std::string &bundleName) const;
     void GetInstallBundleInfos(int32_t argc) const;
     void GetBundleInfosByMetaDataKey(const std::string &metaDataKey) const;
+    void GetInstallState() const;
     void InfoPrint(const std::string &str) const;
 #ifdef OHOS_DEBUG
     void RunAsEnableCommand(int32_t argc, char *argv[]) const;
@@ -69,12 +69,14 @@ const std::string DUMP_HELP_MESSAGE = "Usage: dump [options]\n"
                                       "\t--help|-h                   help menu\n"
                                       "\t--list|-l                   app list\n"
                                       "\t--bundlename|-n           dump installed hap's info\n"
-                                      "\t--metadatakey|-m           dump bundleNames match metaData key\n";
+                                      "\t--metadatakey|-m           dump bundleNames match metaData key\n"
+                                      "\t--installstate|-q          dump the install queue and the latest installs\n";
 const std::string ENABLE_HELP_MESSAGE = "Usage: set [options]\n"
                                         "Option Description:\n"
                                         "\t--externalmode|-e status    enable externalmode\n"
                                         "\t--debugmode|-d  status      enable debugmode\n"
-                                        "\t--signmode|-s  status      enable signmode\n";
+                                        "\t--signmode|-s  status      enable signmode\n"
+                                        "\t--archivemode|-a  status   enable archivemode\n";
 
 const std::string HELP_MESSAGE = INSTALL_HELP_MESSAGE + UNINSTALL_HELP_MESSAGE + DUMP_HELP_MESSAGE +
     ENABLE_HELP_MESSAGE;
@@ -86,23 +88,25 @@ const std::string ERROR_SEM_ERROR = "sem init failed!\n";
 const std::string ERROR_DUMP_FAIL = "no bundle info!\n";
 const std::string ERROR_DUMP_ERROR = "dump info error!\n";
 
-const std::string SHORT_OPTIONS = "n:hlp:m:";
+const std::string SHORT_OPTIONS = "n:hlp:m:q";
 const struct option LONG_OPTIONS[] = {
     {"help", no_argument, nullptr, 'h'},
     {"list", no_argument, nullptr, 'l'},
     {"bundlename", required_argument, nullptr, 'n'},
     {"happath", required_argument, nullptr, 'p'},
     {"metadatakey", required_argument, nullptr, 'm'},
+    {"installstate", no_argument, nullptr, 'q'},
     {nullptr, 0, nullptr, 0}
 };
 
 #ifdef OHOS_DEBUG
-const std::string ENABLE_SHORT_OPTIONS = "he:d:s:";
+const std::string ENABLE_SHORT_OPTIONS = "he:d:s:a:";
 const struct option ENABLE_LONG_OPTIONS[] = {
     {"help", no_argument, nullptr, 'h'},
     {"externalmode", required_argument, nullptr, 'e'},
     {"debugmode", required_argument, nullptr, 'd'},
     {"signmode", required_argument, nullptr, 's'},
+    {"archivemode", required_argument, nullptr, 'a'},
     {nullptr, 0, nullptr, 0}
 };
 #endif
@@ -262,6 +266,9 @@ void CommandParser::RunAsDumpCommand(int32_t argc, char *argv[]) const
         case 'm':
             GetBundleInfosByMetaDataKey(optarg);
             break;
+        case 'q':
+            GetInstallState();
+            break;
         default:
             printf("%s\n", (ERROR_OPTION + DUMP_HELP_MESSAGE).c_str());
             break;
@@ -311,6 +318,9 @@ void CommandParser::RunAsEnableCommand(int32_t argc, char *argv[]) const
         case 's':
             SetDebugMode(optarg, SET_SIGN_MODE);
             break;
+        case 'a':
+            SetDebugMode(optarg, SET_ARCHIVE_INSTALL_MODE);
+            break;
         default:
             printf("%s\n", (ERROR_OPTION + ENABLE_HELP_MESSAGE).c_str());
             break;
@@ -422,6 +432,45 @@ void CommandParser::GetBundleInfosByMetaDataKey(const std::string &metaDataKey)
     BundleInfoUtils::FreeBundleInfos(bundleInfos, len);
 }
 
+static int BmsToolDumpNotify(IOwner owner, int code, IpcIo *reply)
+{
+    if ((reply == nullptr) || (owner == nullptr)) {
+        printf("%s\n", "Bm tool Notify ipc is nullptr");
+        return OHOS_FAILURE;
+    }
+    uint8_t readCode;
+    uint8_t result = ERR_APPEXECFWK_INVOKE_ERROR;
+    ReadUint8(reply, &readCode);
+    ReadUint8(reply, &result);
+    if (readCode != DUMP_INSTALL_STATE || result != OHOS_SUCCESS) {
+        return OHOS_FAILURE;
+    }
+    size_t len = 0;
+    char *state = reinterpret_cast<char *>(ReadString(reply, &len));
+    if (state != nullptr) {
+        *reinterpret_cast<std::string *>(owner) = state;
+    }
+    return ERR_OK;
+}
+
+void CommandParser::GetInstallState() const
+{
+    if (g_bmsInnerClient == nullptr) {
+        printf("%s\n", "Bm tool client is nullptr");
+        return;
+    }
+    IpcIo ipcIo;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&ipcIo, data, MAX_IO_SIZE, 0);
+    std::string state;
+    int32_t ret = g_bmsInnerClient->Invoke(g_bmsInnerClient, DUMP_INSTALL_STATE, &ipcIo, &state, BmsToolDumpNotify);
+    if (ret != ERR_OK || state.empty()) {
+        printf("error message: %s\n", ERROR_DUMP_ERROR.c_str());
+        return;
+    }
+    InfoPrint(state);
+}
+
 #ifdef OHOS_DEBUG
 static int BmsToolNotify(IOwner owner, int code, IpcIo *reply)
 {
@@ -434,7 +483,8 @@ static int BmsToolNotify(IOwner owner, int code, IpcIo *reply)
     switch (readCode) {
         case SET_EXTERNAL_INSTALL_MODE:
         case SET_SIGN_DEBUG_MODE:
-        case SET_SIGN_MODE: {
+        case SET_SIGN_MODE:
+        case SET_ARCHIVE_INSTALL_MODE: {
             uint8_t *ret = reinterpret_cast<uint8_t *>(owner);
             ReadUint8(reply, ret);
             break;